@@ -0,0 +1,97 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- counters and events of template and dictionary caches.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGCACHESTATS_H
+#define TENGCACHESTATS_H
+
+#include <string>
+#include <cstdint>
+#include <functional>
+
+namespace Teng {
+
+/** @short Counters of one cache. The times are in nanoseconds.
+ */
+struct CacheStats_t {
+    uint64_t hits = 0;           //!< entry found and still valid
+    uint64_t misses = 0;         //!< entry not found
+    uint64_t evictions = 0;      //!< entries evicted to make room
+    uint64_t changedReloads = 0; //!< reloads caused by changed source files
+    uint64_t dependReloads = 0;  //!< reloads caused by reloaded dependency
+    uint64_t loads = 0;          //!< compilations or parses of entries
+    uint64_t loadTime = 0;       //!< the cumulative load time (compile time)
+    uint64_t memory = 0;         //!< the estimated heap footprint of entries
+};
+
+/** @short Counters of all caches of the engine.
+ */
+struct CachesStats_t {
+    CacheStats_t programs; //!< the cache of compiled templates
+    CacheStats_t dicts;    //!< the cache of language dictionaries
+    CacheStats_t params;   //!< the cache of config dictionaries
+};
+
+/** @short Describes the load (compilation) or eviction of cache entry.
+ */
+struct CacheEvent_t {
+    /** The cache the entry belongs to.
+     */
+    enum CacheId_t {PROGRAMS, DICTS, PARAMS};
+
+    /** Why the event happened.
+     */
+    enum Reason_t {
+        MISSING,          //!< loaded since entry has not been cached
+        SOURCE_CHANGED,   //!< reloaded since source files have changed
+        DEPENDS_CHANGED,  //!< reloaded since config has been reloaded
+        EVICTED,          //!< evicted to make room for another entry
+    };
+
+    CacheId_t cache;   //!< the cache
+    Reason_t reason;   //!< the reason
+    std::string key;   //!< the filename (or md5 of template string)
+    uint64_t time = 0; //!< the load time in nanoseconds (0 for evictions)
+};
+
+/** @short The callback called on each load or eviction of cache entry.
+ */
+using CacheCallback_t = std::function<void (const CacheEvent_t &)>;
+
+} // namespace Teng
+
+#endif /* TENGCACHESTATS_H */
+
@@ -0,0 +1,76 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- timing breakdown of template compilation.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGCOMPILEREPORT_H
+#define TENGCOMPILEREPORT_H
+
+#include <cstdint>
+#include <ostream>
+
+namespace Teng {
+
+/** @short The timing breakdown of template compilation. It's collected only
+ * if the compilereport feature is enabled in the configuration. The times
+ * are in nanoseconds.
+ */
+struct CompileReport_t {
+    uint64_t totalTime = 0;      //!< the whole compilation
+    uint64_t lex1Time = 0;       //!< level 1 lexing (Lex1_t)
+    uint64_t lex2Time = 0;       //!< level 2 lexing (flex)
+    uint64_t parseTime = 0;      //!< bison parser and semantic actions
+    uint64_t evalTime = 0;       //!< constant folding by the coprocessor
+    uint64_t readTime = 0;       //!< reading of template files
+    uint64_t finishTime = 0;     //!< specialization of prints
+    uint64_t lex1Tokens = 0;     //!< the number of level 1 tokens
+    uint64_t lex2Tokens = 0;     //!< the number of level 2 tokens
+    uint64_t files = 0;          //!< the number of read files
+    uint64_t fileBytes = 0;      //!< the size of read files
+    uint64_t reparses = 0;       //!< sources parsed again (overrides)
+    uint64_t reparsedBytes = 0;  //!< the size of sources parsed again
+    uint64_t evalAttempts = 0;   //!< the number of constant folding attempts
+    uint64_t evalSuccesses = 0;  //!< the number of folded expressions
+    uint64_t instructions = 0;   //!< the number of program instructions
+};
+
+/** @short Writes human readable representation of the report to stream.
+ */
+std::ostream &operator<<(std::ostream &os, const CompileReport_t &report);
+
+} // namespace Teng
+
+#endif /* TENGCOMPILEREPORT_H */
+
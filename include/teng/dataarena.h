@@ -0,0 +1,97 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- arena for building data trees.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGDATAARENA_H
+#define TENGDATAARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace Teng {
+
+/** Monotonic memory arena that the data tree (Fragment_t, FragmentList_t and
+ * all their nested fragments and lists) can be allocated from. The memory is
+ * handed out by bumping pointer, the deallocations are no-ops and the memory
+ * is returned to the system when the arena is destroyed, so building of
+ * large trees does not pay for one malloc/free per node.
+ *
+ * The destruction of tree still walks all its nodes and runs their
+ * destructors. The names of variables and the string values are plain
+ * std::strings, so those that don't fit into the small string buffer are
+ * allocated and freed on the heap one by one as before.
+ *
+ * The arena must outlive all trees allocated from it.
+ *
+ * Example:
+ *
+ * Teng::DataArena_t arena;
+ * Teng::Fragment_t root(arena);
+ * auto &row = root.addFragment("row");   // allocated from arena as well
+ * row.addVariable("name", "value");
+ */
+class DataArena_t {
+public:
+    // types
+    using Resource_t = std::pmr::memory_resource;
+
+    // don't copy
+    DataArena_t(const DataArena_t &) = delete;
+    DataArena_t &operator=(const DataArena_t &) = delete;
+
+    /** C'tor.
+     * @param initial_size the size of the first memory block
+     */
+    explicit DataArena_t(std::size_t initial_size = 64 * 1024)
+        : buffer(initial_size)
+    {}
+
+    /** Returns memory resource that allocates from arena.
+     */
+    Resource_t *resource() {return &buffer;}
+
+    /** Returns all memory to the system. It must not be called while any
+     * tree allocated from the arena is alive.
+     */
+    void release() {buffer.release();}
+
+private:
+    std::pmr::monotonic_buffer_resource buffer; //!< the memory blocks
+};
+
+} // namespace Teng
+
+#endif /* TENGDATAARENA_H */
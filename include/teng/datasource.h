@@ -0,0 +1,143 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- abstract source of template data.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGDATASOURCE_H
+#define TENGDATASOURCE_H
+
+#include <cstdint>
+#include <functional>
+
+#include <teng/value.h>
+#include <teng/stringview.h>
+
+namespace Teng {
+
+/** Data tree that the template engine traverses without converting it to
+ * Fragment_t. The processor asks the source for the attributes of fragments
+ * and for the items of lists as the template reads them, so the application
+ * can expose its own structures or compute the values on first access.
+ *
+ * The fragments and lists are identified by nodes (see DataNode_t) that the
+ * source creates by frag() and list() methods, the meaning of their ptr and id
+ * members is up to the source. The string values may be string_ref values
+ * that point to data owned by the source. The source has to outlive the
+ * rendering and if it is rendered by more threads at once its methods must be
+ * thread safe.
+ *
+ * The native data tree (Fragment_t) is accessed directly by the processor, it
+ * does not go through this interface.
+ *
+ * Example:
+ *
+ * struct Users_t: Teng::DataSource_t {
+ *     Teng::Value_t root() const override {return frag(nullptr);}
+ *     Teng::Value_t
+ *     attr(const Teng::DataNode_t &node, const Teng::string_view_t &name)
+ *     const override {
+ *         if (!node.ptr) return name == "user"? list(&db): Teng::Value_t();
+ *         auto *user = static_cast<const User_t *>(node.ptr);
+ *         return name == "name"? Teng::Value_t(user->name): Teng::Value_t();
+ *     }
+ *     std::size_t size(const Teng::DataNode_t &) const override {
+ *         return db.size();
+ *     }
+ *     Teng::Value_t item(const Teng::DataNode_t &, std::size_t i)
+ *     const override {return frag(&db[i]);}
+ *     ...
+ * };
+ *
+ * teng.generatePage(args, users, writer, err);
+ */
+class DataSource_t {
+public:
+    // types
+    using Visitor_t
+        = std::function<void(const string_view_t &, const Value_t &)>;
+
+    /** D'tor.
+     */
+    virtual ~DataSource_t() noexcept = default;
+
+    /** Returns the root fragment of the tree.
+     */
+    virtual Value_t root() const = 0;
+
+    /** Returns the value of the fragment attribute or undefined value if the
+     * fragment has no such attribute.
+     * @param frag the fragment node
+     * @param name the attribute name
+     */
+    virtual Value_t
+    attr(const DataNode_t &frag, const string_view_t &name) const = 0;
+
+    /** Returns the number of list items.
+     * @param list the list node
+     */
+    virtual std::size_t size(const DataNode_t &list) const = 0;
+
+    /** Returns the i-th list item, the index is always less than size().
+     * @param list the list node
+     * @param i the item index
+     */
+    virtual Value_t item(const DataNode_t &list, std::size_t i) const = 0;
+
+    /** Calls the visitor for each attribute of the fragment. It is used for
+     * debug output, jsonify() and isempty(), the rendering of regular
+     * templates does not need it.
+     * @param frag the fragment node
+     * @param visitor the callback that accepts the name and the value
+     */
+    virtual void
+    visit(const DataNode_t &frag, const Visitor_t &visitor) const = 0;
+
+protected:
+    /** Returns value referencing the fragment node of this source.
+     */
+    Value_t frag(const void *ptr, uint64_t id = 0) const {
+        return Value_t(Value_t::frag_ref_type{{this, ptr, id}});
+    }
+
+    /** Returns value referencing the list node of this source.
+     */
+    Value_t list(const void *ptr, uint64_t id = 0) const {
+        return Value_t(Value_t::list_ref_type{{this, ptr, id}, 0});
+    }
+};
+
+} // namespace Teng
+
+#endif /* TENGDATASOURCE_H */
@@ -0,0 +1,216 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng writer compressing the output by zlib deflate.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGDEFLATEWRITER_H
+#define TENGDEFLATEWRITER_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <teng/writer.h>
+
+namespace Teng {
+
+/** @short Cache of compressed template literals shared by deflate writers.
+ *
+ * Each literal is compressed alone (without any history) and terminated by
+ * the full flush so it can be spliced into any deflate stream that has been
+ * fully flushed too. Only the literals of templates (see
+ * Writer_t::writeLiteral()) are cached, the values of variables are always
+ * compressed as a part of the stream. The literals and their compressed
+ * forms occupy at most maxBytes bytes; once the cache is full, new literals
+ * are not cached at all. The cache is thread safe.
+ */
+class DeflateCache_t {
+public:
+    /** @short Create new cache.
+     *  @param minSize the minimal size of the cached literal
+     *  @param maxBytes the max number of bytes of the cached literals
+     *  @param level zlib compression level (-1 means zlib default)
+     */
+    explicit DeflateCache_t(
+        std::size_t minSize = 1024,
+        std::size_t maxBytes = 16 * 1024 * 1024,
+        int level = -1
+    );
+
+    /** @short Destroys the cache.
+     */
+    ~DeflateCache_t();
+
+    /** @short Returns true if the string of given size should be cached.
+     */
+    bool isCacheable(std::size_t size) const {return size >= minSize;}
+
+    /** @short Returns compressed form of given literal. The literal is
+     *  compressed and remembered if it is not cached yet and if there is
+     *  a space for it.
+     *  @param str literal to be compressed
+     *  @param size length of the literal
+     *  @return compressed literal or nullptr if the literal is not cached
+     */
+    std::shared_ptr<const std::string>
+    compress(const char *str, std::size_t size);
+
+    /** @short Returns the number of cached literals.
+     */
+    std::size_t size() const;
+
+private:
+    // types
+    struct Entry_t;
+    using Entries_t
+        = std::unordered_map<std::string_view, std::unique_ptr<Entry_t>>;
+
+    const std::size_t minSize;  //!< the minimal size of the cached literal
+    const std::size_t maxBytes; //!< the max number of the cached bytes
+    const int level;            //!< zlib compression level
+    mutable std::mutex mutex;   //!< guards the entries
+    Entries_t entries;          //!< literal to compressed literal mapping
+    std::size_t bytes;          //!< the number of the cached bytes
+};
+
+/** @short Output writer. Compresses the output by zlib deflate and writes
+ *  the compressed data to the underlying writer.
+ *
+ * The output is compressed incrementally as it is written. The flush()
+ * performs zlib sync flush so all data written so far can be decompressed
+ * by the client. The stream has to be terminated by explicit finish(),
+ * the destructor only releases the zlib stream, so it never writes to the
+ * underlying writer (that could throw) and the unfinished stream stays
+ * truncated.
+ */
+class DeflateWriter_t : public Writer_t {
+public:
+    /** @short Format of the compressed stream.
+     */
+    enum Format_t {
+        FORMAT_GZIP, //!< gzip header and trailer (Content-Encoding: gzip)
+        FORMAT_RAW,  //!< raw deflate data without header and trailer
+    };
+
+    /** @short Create new writer.
+     *  @param output underlying writer receiving compressed data
+     *  @param format format of the compressed stream
+     *  @param level zlib compression level (-1 means zlib default)
+     *  @param cache optional cache of compressed literals
+     */
+    explicit DeflateWriter_t(
+        Writer_t &output,
+        Format_t format = FORMAT_GZIP,
+        int level = -1,
+        std::shared_ptr<DeflateCache_t> cache = {}
+    );
+
+    /** @short Releases the zlib stream. It does not terminate the stream,
+     *  call finish() before.
+     */
+    ~DeflateWriter_t() override;
+
+    /** @short Write given string to output.
+     *  @param str string to be written
+     *  @return 0 OK, !0 error
+     */
+    int write(const std::string &str) override;
+
+    /** @short Write given string to output.
+     *  @param str string to be written
+     *  @return 0 OK, !0 error
+     */
+    int write(const char *str) override;
+
+    /** @short Write given string to output.
+     *  @param str string to be written
+     *  @return 0 OK, !0 error
+     */
+    int write(const char *str, std::size_t size) override;
+
+    /** @short Write given string to output.
+     *  @param str string to be written
+     *  @param interval iterators to given string, only this part
+     *                  shall be written
+     *  @return 0 OK, !0 error
+     */
+    int write(const std::string &str, StringSpan_t interval) override;
+
+    /** @short Write literal of the template to output. The compressed
+     *  literal is taken from the cache if there is any.
+     *  @param str literal to be written
+     *  @param size length of the literal
+     *  @return 0 OK, !0 error
+     */
+    int writeLiteral(const char *str, std::size_t size) override;
+
+    /** @short Compresses all pending data (zlib sync flush) and flushes
+     *  the underlying writer.
+     *  @return 0 OK, !0 error
+     */
+    int flush() override;
+
+    /** @short Terminates the compressed stream and flushes the underlying
+     *  writer. Nothing can be written after the stream is finished.
+     *  @return 0 OK, !0 error
+     */
+    int finish();
+
+private:
+    struct Stream_t;
+
+    /** @short Passes data to the deflate stream.
+     */
+    int deflate(const char *str, std::size_t size, int mode);
+
+    /** @short Writes gzip header before the first compressed data.
+     */
+    int start();
+
+    /** @short Updates the checksum of the uncompressed data.
+     */
+    void checksum(const char *str, std::size_t size);
+
+    Writer_t &output;                      //!< underlying writer
+    Format_t format;                       //!< stream format
+    std::shared_ptr<DeflateCache_t> cache; //!< compressed literals
+    std::unique_ptr<Stream_t> stream;      //!< zlib stream and its state
+};
+
+} // namespace Teng
+
+#endif // TENGDEFLATEWRITER_H
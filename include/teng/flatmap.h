@@ -0,0 +1,343 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- map of items indexed by sorted vector.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGFLATMAP_H
+#define TENGFLATMAP_H
+
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+namespace Teng {
+
+/** Associative container with the subset of std::map interface used by
+ * Fragment_t. The items are stored contiguously in one vector in order of
+ * insertion and the positions of the items are kept in the index vector
+ * sorted by the key, so the lookups do binary search over contiguous memory
+ * and there is no allocation per item.
+ *
+ * The items never move on insertion unless the items vector is reallocated,
+ * so the insertion invalidates the references to the items only if it
+ * exceeds the reserved capacity. It always invalidates the iterators.
+ */
+template <
+    typename Key_t,
+    typename Value_t,
+    typename Cmp_t,
+    typename Alloc_t = std::allocator<std::pair<const Key_t, Value_t>>
+> class FlatMap_t {
+public:
+    // types
+    using key_type = Key_t;
+    using mapped_type = Value_t;
+    using value_type = std::pair<const Key_t, Value_t>;
+    using allocator_type = Alloc_t;
+    using size_type = std::size_t;
+
+private:
+    // types
+    using ItemsAlloc_t = typename std::allocator_traits<Alloc_t>
+        ::template rebind_alloc<value_type>;
+    using Items_t = std::vector<value_type, ItemsAlloc_t>;
+    using IndexAlloc_t = typename std::allocator_traits<Alloc_t>
+        ::template rebind_alloc<size_type>;
+    using Index_t = std::vector<size_type, IndexAlloc_t>;
+    using Pos_t = typename Index_t::const_iterator;
+
+    /** Iterator over items in key order, it dereferences the positions in
+     * index vector.
+     */
+    template <typename Item_t>
+    class Iterator_t {
+    public:
+        // types
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<Item_t>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Item_t *;
+        using reference = Item_t &;
+
+        /** C'tor.
+         */
+        Iterator_t() = default;
+
+        /** C'tor: conversion from non const iterator.
+         */
+        template <
+            typename Other_t,
+            std::enable_if_t<std::is_const_v<Item_t>
+                && std::is_same_v<const Other_t, Item_t>, bool> = true
+        > Iterator_t(const Iterator_t<Other_t> &other)
+            : ipos(other.ipos), items(other.items)
+        {}
+
+        reference operator*() const {return items[*ipos];}
+        pointer operator->() const {return items + *ipos;}
+        reference operator[](difference_type i) const {
+            return items[ipos[i]];
+        }
+        Iterator_t &operator++() {++ipos; return *this;}
+        Iterator_t &operator--() {--ipos; return *this;}
+        Iterator_t operator++(int) {return Iterator_t(ipos++, items);}
+        Iterator_t operator--(int) {return Iterator_t(ipos--, items);}
+        Iterator_t &operator+=(difference_type n) {ipos += n; return *this;}
+        Iterator_t &operator-=(difference_type n) {ipos -= n; return *this;}
+        Iterator_t operator+(difference_type n) const {
+            return Iterator_t(ipos + n, items);
+        }
+        Iterator_t operator-(difference_type n) const {
+            return Iterator_t(ipos - n, items);
+        }
+        difference_type operator-(const Iterator_t &other) const {
+            return ipos - other.ipos;
+        }
+        bool operator==(const Iterator_t &o) const {return ipos == o.ipos;}
+        bool operator!=(const Iterator_t &o) const {return ipos != o.ipos;}
+        bool operator<(const Iterator_t &o) const {return ipos < o.ipos;}
+
+    private:
+        template <typename> friend class Iterator_t;
+        friend class FlatMap_t;
+
+        /** C'tor.
+         */
+        Iterator_t(Pos_t ipos, Item_t *items): ipos(ipos), items(items) {}
+
+        Pos_t ipos;             //!< the position of the item in index vector
+        Item_t *items{nullptr}; //!< the first item in items vector
+    };
+
+public:
+    // types
+    using iterator = Iterator_t<value_type>;
+    using const_iterator = Iterator_t<const value_type>;
+
+    /** C'tor.
+     */
+    FlatMap_t() = default;
+
+    /** C'tor: items are allocated by given allocator.
+     */
+    explicit FlatMap_t(const Alloc_t &alloc)
+        : items(ItemsAlloc_t(alloc)), index(IndexAlloc_t(alloc))
+    {}
+
+    /** C'tor: move.
+     */
+    FlatMap_t(FlatMap_t &&other) noexcept = default;
+
+    /** Assignment: move. If the allocators differ the items are moved one
+     * by one to the memory of this container, as std::map does.
+     */
+    FlatMap_t &operator=(FlatMap_t &&other) {
+        if (this == &other) return *this;
+        clear();
+        if (get_allocator() == other.get_allocator()) {
+            items.swap(other.items);
+            index.swap(other.index);
+            return *this;
+        }
+        items.reserve(other.size());
+        for (auto &item: other.items)
+            items.emplace_back(
+                std::piecewise_construct,
+                std::forward_as_tuple(
+                    std::move(const_cast<Key_t &>(item.first))),
+                std::forward_as_tuple(std::move(item.second))
+            );
+        index.assign(other.index.begin(), other.index.end());
+        other.clear();
+        return *this;
+    }
+
+    // don't copy
+    FlatMap_t(const FlatMap_t &) = delete;
+    FlatMap_t &operator=(const FlatMap_t &) = delete;
+
+    /** D'tor.
+     */
+    ~FlatMap_t() = default;
+
+    /** Returns the allocator of items.
+     */
+    allocator_type get_allocator() const {return items.get_allocator();}
+
+    /** Returns iterator to the item of given key or end().
+     */
+    template <typename Type_t>
+    iterator find(const Type_t &key) {
+        auto ipos = lower_bound(key);
+        if ((ipos != index.end()) && !cmp(key, items[*ipos].first))
+            return make_iterator(ipos);
+        return end();
+    }
+
+    /** Returns iterator to the item of given key or end().
+     */
+    template <typename Type_t>
+    const_iterator find(const Type_t &key) const {
+        auto ipos = lower_bound(key);
+        if ((ipos != index.end()) && !cmp(key, items[*ipos].first))
+            return make_iterator(ipos);
+        return end();
+    }
+
+    /** Inserts new item if there is no item of given key. The hint is used
+     * as insert position if the sort order is kept.
+     */
+    template <typename Arg_t, typename... Args_t>
+    iterator emplace_hint(const_iterator hint, Arg_t &&key, Args_t &&...args) {
+        auto ipos = hint.ipos;
+        if (!is_valid_hint(ipos, key)) {
+            ipos = lower_bound(key);
+            if ((ipos != index.end()) && !cmp(key, items[*ipos].first))
+                return make_iterator(ipos);
+        }
+        return insert(ipos, std::forward<Arg_t>(key),
+                      std::forward<Args_t>(args)...);
+    }
+
+    /** Inserts new item if there is no item of given key.
+     */
+    template <typename Arg_t, typename... Args_t>
+    std::pair<iterator, bool> emplace(Arg_t &&key, Args_t &&...args) {
+        auto ipos = lower_bound(key);
+        if ((ipos != index.end()) && !cmp(key, items[*ipos].first))
+            return {make_iterator(ipos), false};
+        auto iitem = insert(ipos, std::forward<Arg_t>(key),
+                            std::forward<Args_t>(args)...);
+        return {iitem, true};
+    }
+
+    /** Reserves space for given number of items.
+     */
+    void reserve(size_type size) {
+        items.reserve(size);
+        index.reserve(size);
+    }
+
+    /** Removes all items.
+     */
+    void clear() noexcept {
+        index.clear();
+        items.clear();
+    }
+
+    /** Returns iterator to the first item.
+     */
+    const_iterator begin() const {return make_iterator(index.cbegin());}
+    const_iterator cbegin() const {return make_iterator(index.cbegin());}
+    iterator begin() {return make_iterator(index.cbegin());}
+
+    /** Returns iterator one past the last item.
+     */
+    const_iterator end() const {return make_iterator(index.cend());}
+    const_iterator cend() const {return make_iterator(index.cend());}
+    iterator end() {return make_iterator(index.cend());}
+
+    /** Returns true if there is no item.
+     */
+    bool empty() const {return index.empty();}
+
+    /** Returns the number of items.
+     */
+    size_type size() const {return index.size();}
+
+private:
+    /** Returns iterator to the item at given position of index.
+     */
+    iterator make_iterator(Pos_t ipos) {return iterator(ipos, items.data());}
+
+    /** Returns iterator to the item at given position of index.
+     */
+    const_iterator make_iterator(Pos_t ipos) const {
+        return const_iterator(ipos, items.data());
+    }
+
+    /** Returns position of the first item not less than key.
+     */
+    template <typename Type_t>
+    Pos_t lower_bound(const Type_t &key) const {
+        return std::lower_bound(
+            index.cbegin(), index.cend(), key,
+            [&] (size_type pos, const Type_t &key) {
+                return cmp(items[pos].first, key);
+            }
+        );
+    }
+
+    /** Returns true if key can be inserted before hint.
+     */
+    template <typename Type_t>
+    bool is_valid_hint(Pos_t hint, const Type_t &key) const {
+        if ((hint != index.cend()) && !cmp(key, items[*hint].first))
+            return false;
+        if ((hint != index.cbegin())
+            && !cmp(items[*std::prev(hint)].first, key)) return false;
+        return true;
+    }
+
+    /** Appends new item and inserts its position before given position of
+     * index.
+     */
+    template <typename Arg_t, typename... Args_t>
+    iterator insert(Pos_t ipos, Arg_t &&key, Args_t &&...args) {
+        items.emplace_back(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<Arg_t>(key)),
+            std::forward_as_tuple(std::forward<Args_t>(args)...)
+        );
+        try {
+            return make_iterator(index.insert(ipos, items.size() - 1));
+        } catch (...) {
+            items.pop_back();
+            throw;
+        }
+    }
+
+    Cmp_t cmp;     //!< keys comparator
+    Items_t items; //!< items in order of insertion
+    Index_t index; //!< positions of items sorted by key
+};
+
+} // namespace Teng
+
+#endif /* TENGFLATMAP_H */
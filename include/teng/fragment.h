@@ -38,11 +38,16 @@
 #define TENGFRAGMENT_H
 
 #include <map>
+#include <memory>
 #include <string>
 #include <cstdint>
 #include <type_traits>
 
 #include <teng/types.h>
+#include <teng/config.h>
+#include <teng/stringview.h>
+#include <teng/flatmap.h>
+#include <teng/dataarena.h>
 
 namespace Teng {
 
@@ -66,7 +71,15 @@ class Fragment_t {
 public:
     // types
     using Item_t = FragmentValue_t;
-    using Items_t = std::map<std::string, Item_t, StrCmp_t>;
+    using Resource_t = DataArena_t::Resource_t;
+    using Alloc_t = std::pmr::polymorphic_allocator<
+        std::pair<const std::string, Item_t>
+    >;
+#if TENG_FLAT_FRAGMENT
+    using Items_t = FlatMap_t<std::string, Item_t, StrCmp_t, Alloc_t>;
+#else /* TENG_FLAT_FRAGMENT */
+    using Items_t = std::map<std::string, Item_t, StrCmp_t, Alloc_t>;
+#endif /* TENG_FLAT_FRAGMENT */
     using const_iterator = Items_t::const_iterator;
     using iterator = Items_t::iterator;
 
@@ -79,15 +92,33 @@ public:
      */
     Fragment_t() noexcept = default;
 
+    /**
+     * @short C'tor: fragment and all its nested fragments and fragment lists
+     * are allocated from the arena.
+     */
+    explicit Fragment_t(DataArena_t &arena)
+        : items(Alloc_t(arena.resource()))
+    {}
+
+    /**
+     * @short C'tor: fragment and all its nested fragments and fragment lists
+     * are allocated from the memory resource.
+     */
+    explicit Fragment_t(Resource_t *resource)
+        : items(Alloc_t(resource))
+    {}
+
     /**
      * @short C'tor: move.
      */
     Fragment_t(Fragment_t &&other) noexcept = default;
 
     /**
-     * @short Assigment: move.
+     * @short Assigment: move. If the fragments are allocated from different
+     * memory resources the items are moved one by one to the resource of
+     * this fragment, so the assignment may allocate (and throw).
      */
-    Fragment_t &operator=(Fragment_t &&other) noexcept = default;
+    Fragment_t &operator=(Fragment_t &&other) = default;
 
     /** D'tor.
      */
@@ -155,19 +186,44 @@ public:
     }
 
     /**
-     * @short Add nested fragment.
+     * @short Add variable to fragment.
+     * @param name variable name
+     * @param value variable value
+     */
+    void addStringVariable(const std::string &name, std::string &&value) {
+        addVariable(name, std::move(value));
+    }
+
+    /**
+     * @short Add nested fragment. The fragment is stored in the fragment
+     * list of given name, so the reference is invalidated by adding next
+     * fragment of the same name, not by adding other items to this fragment.
      * @param name fragment name
      * @return created fragment
      */
     Fragment_t &addFragment(const std::string &name);
 
     /**
-     * @short Add new nested fragment list.
+     * @short Add new nested fragment list. If the items are stored in flat
+     * vector (TENG_FLAT_FRAGMENT) the reference is invalidated by adding
+     * other items to this fragment beyond reserved capacity.
      * @param name fragment name
      * @return created fragment list
      */
     FragmentList_t &addFragmentList(const std::string &name);
 
+    /**
+     * @short Mounts shared immutable fragment under given name. The fragment
+     * is not copied, it is referenced and kept alive by this fragment, so
+     * the same subtree can be mounted to many concurrently rendered trees.
+     * @param name fragment name
+     * @param value the shared fragment
+     */
+    void addSharedFragment(
+        const std::string &name,
+        std::shared_ptr<const Fragment_t> value
+    );
+
     /**
      * @short Add some frag value to fragment.
      * @param name variable name
@@ -201,6 +257,15 @@ public:
      */
     void json(std::ostream &o) const;
 
+    /**
+     * @short Returns value of desired name or nullptr.
+     */
+    template <typename Type_t>
+    const Item_t *get(const Type_t &name) const {
+        auto iitem = items.find(name);
+        return iitem != items.end()? &iitem->second: nullptr;
+    }
+
     /**
      * @short Returns iterator to fragment item of desired name.
      */
@@ -242,7 +307,21 @@ public:
      */
     std::size_t size() const {return items.size();}
 
+    /**
+     * @short Reserves space for given number of items (if the storage
+     * allows it).
+     */
+    void reserve(std::size_t size);
+
+    /**
+     * @short Returns the memory resource the fragment is allocated from.
+     */
+    Resource_t *resource() const {return items.get_allocator().resource();}
+
 protected:
+    // my close friends
+    friend FragmentList_t;
+
     Items_t items; //!< fragments data
 };
 
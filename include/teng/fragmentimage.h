@@ -0,0 +1,129 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- binary image of data tree.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGFRAGMENTIMAGE_H
+#define TENGFRAGMENTIMAGE_H
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include <teng/fragment.h>
+#include <teng/datasource.h>
+
+namespace Teng {
+
+/** Returns binary image of the data tree. The image can be stored to file and
+ * rendered later through FragmentImage_t without deserialization.
+ *
+ * The image consists of header, array of fixed size nodes, index of fragment
+ * keys and list items and pool of strings. It uses the native byte order, so
+ * it is not portable between architectures of different endianness.
+ */
+std::string makeFragmentImage(const Fragment_t &root);
+
+/** Read-only view of data tree image created by makeFragmentImage(). The
+ * template is rendered directly from the image (see DataSource_t): the string
+ * values are references to the image, the fragment keys are stored sorted and
+ * they are looked up by binary search and the list items are indexed. So the
+ * rendering touches only the parts of the image that the template reads.
+ *
+ * The image is not validated as a whole when it is opened, each node is
+ * checked when it is accessed and std::runtime_error is thrown if it is
+ * corrupted.
+ *
+ * Example:
+ *
+ * Teng::FragmentImage_t image("data.img");   // mmaps the file
+ * teng.generatePage(args, image, writer, err);
+ */
+class FragmentImage_t: public DataSource_t {
+public:
+    // types
+    struct Image_t;
+
+    /** C'tor: maps the image file to memory.
+     * @param filename the file with image
+     * @throw std::runtime_error if file can't be mapped or it is not image
+     */
+    explicit FragmentImage_t(const std::string &filename);
+
+    /** Returns view of the image stored in memory.
+     * @param data the image data
+     * @throw std::runtime_error if the data is not image
+     */
+    static FragmentImage_t fromString(std::string data);
+
+    /** Returns the root fragment of image.
+     */
+    Value_t root() const override;
+
+    /** Returns the value of the fragment key.
+     */
+    Value_t
+    attr(const DataNode_t &frag, const string_view_t &name) const override;
+
+    /** Returns the number of list items.
+     */
+    std::size_t size(const DataNode_t &list) const override;
+
+    /** Returns the i-th list item.
+     */
+    Value_t item(const DataNode_t &list, std::size_t i) const override;
+
+    /** Calls the visitor for each key of fragment in sorted order.
+     */
+    void
+    visit(const DataNode_t &frag, const Visitor_t &visitor) const override;
+
+private:
+    /** C'tor.
+     */
+    explicit FragmentImage_t(std::shared_ptr<const Image_t> image)
+        : image(std::move(image))
+    {}
+
+    /** Returns the value of the node.
+     */
+    Value_t value(uint64_t node) const;
+
+    std::shared_ptr<const Image_t> image; //!< the image data
+};
+
+} // namespace Teng
+
+#endif /* TENGFRAGMENTIMAGE_H */
@@ -37,10 +37,14 @@
 #ifndef TENGFRAGMENTLIST_H
 #define TENGFRAGMENTLIST_H
 
+#include <mutex>
 #include <string>
 #include <vector>
+#include <memory>
 
 #include <teng/types.h>
+#include <teng/dataarena.h>
+#include <teng/stringview.h>
 
 namespace Teng {
 
@@ -49,13 +53,98 @@ class Fragment_t;
 class FragmentValue_t;
 class FragmentList_t;
 
+/**
+ * @short Columnar data of fragments that share the same variables. Each
+ * column holds values of one variable for all the fragments (rows). It is
+ * either source for FragmentList_t::addFragments() or storage of columnar
+ * fragment list.
+ */
+class FragmentColumns_t {
+public:
+    /** Column of values.
+     */
+    struct Column_t {
+        enum class tag {integral, real, string};
+        Column_t(const std::string &name, tag type)
+            : name(name), type(type)
+        {}
+        std::string name;                  //!< the variable name
+        tag type;                          //!< the type of values
+        std::vector<IntType_t> integrals;  //!< the integral values
+        std::vector<double> reals;         //!< the real values
+        std::vector<std::string> strings;  //!< the string values
+    };
+
+    // types
+    using const_iterator = std::vector<Column_t>::const_iterator;
+
+    /**
+     * @short Adds column of integral values.
+     * @param name variable name
+     * @param values values of variable for all fragments
+     */
+    void addColumn(const std::string &name, std::vector<IntType_t> values);
+
+    /**
+     * @short Adds column of real values.
+     * @param name variable name
+     * @param values values of variable for all fragments
+     */
+    void addColumn(const std::string &name, std::vector<double> values);
+
+    /**
+     * @short Adds column of string values.
+     * @param name variable name
+     * @param values values of variable for all fragments
+     */
+    void addColumn(const std::string &name, std::vector<std::string> values);
+
+    /**
+     * @short Returns the number of fragments (rows).
+     */
+    std::size_t size() const {return rows;}
+
+    /**
+     * @short Returns the column of given name or nullptr.
+     */
+    const Column_t *find(const string_view_t &name) const;
+
+    /**
+     * @short Returns iterator to first column.
+     */
+    const_iterator begin() const {return columns.begin();}
+
+    /**
+     * @short Returns iterator one past the last column.
+     */
+    const_iterator end() const {return columns.end();}
+
+protected:
+    // my close friends
+    friend FragmentList_t;
+
+    /** Appends new column and checks its size.
+     */
+    Column_t &
+    append(const std::string &name, Column_t::tag type, std::size_t n);
+
+    /** Sorts the columns by names.
+     */
+    void sort();
+
+    std::vector<Column_t> columns; //!< the columns
+    std::size_t rows = 0;          //!< the number of rows
+};
+
 /**
  * @short List of fragment values of same name at same level.
  */
 class FragmentList_t {
 public:
     // types
-    using Items_t = std::vector<FragmentValue_t>;
+    using Resource_t = DataArena_t::Resource_t;
+    using Alloc_t = std::pmr::polymorphic_allocator<FragmentValue_t>;
+    using Items_t = std::vector<FragmentValue_t, Alloc_t>;
     using size_type = Items_t::size_type;
     using const_iterator = Items_t::const_iterator;
     using iterator = Items_t::iterator;
@@ -68,15 +157,42 @@ public:
      */
      FragmentList_t() noexcept = default;
 
+    /**
+     * @short C'tor: list and all its nested fragments and fragment lists
+     * are allocated from the arena.
+     */
+    explicit FragmentList_t(DataArena_t &arena)
+        : items(Alloc_t(arena.resource()))
+    {}
+
+    /**
+     * @short C'tor: list and all its nested fragments and fragment lists
+     * are allocated from the memory resource.
+     */
+    explicit FragmentList_t(Resource_t *resource)
+        : items(Alloc_t(resource))
+    {}
+
+    /**
+     * @short C'tor: columnar list. The fragments are not built, the values
+     * are read directly from the columns while the template is rendered.
+     * Any modification of the list converts it to list of fragments. The
+     * const access to the items builds the fragments once and keeps them
+     * next to the columns.
+     */
+    explicit FragmentList_t(FragmentColumns_t &&columns);
+
     /**
      * @short C'tor: move.
      */
     FragmentList_t(FragmentList_t &&other) noexcept = default;
 
     /**
-     * @short Assigment: move.
+     * @short Assigment: move. If the lists are allocated from different
+     * memory resources the items are moved one by one to the resource of
+     * this list, so the assignment may allocate (and throw).
      */
-    FragmentList_t &operator=(FragmentList_t &&other) noexcept = default;
+    FragmentList_t &operator=(FragmentList_t &&other) = default;
 
     /** D'tor.
      */
@@ -88,6 +204,25 @@ public:
      */
     Fragment_t &addFragment();
 
+    /**
+     * @short Appends shared immutable fragment to fragment list. The fragment
+     * is not copied, it is referenced and kept alive by this list.
+     * @param value the shared fragment
+     */
+    void addSharedFragment(std::shared_ptr<const Fragment_t> value);
+
+    /**
+     * @short Appends one fragment for each row of the columns. The string
+     * values are moved to the fragments.
+     * @param columns the columns of values
+     */
+    void addFragments(FragmentColumns_t &&columns);
+
+    /**
+     * @short Reserves space for given number of items.
+     */
+    void reserve(size_type size) {materialize(); items.reserve(size);}
+
     /**
      * @short Add fragment list to fragment list.
      * @return created fragment
@@ -100,6 +235,12 @@ public:
      */
     void addValue(const std::string &value);
 
+    /**
+     * @short Add value to list..
+     * @param value variable value
+     */
+    void addValue(std::string &&value);
+
     /**
      * @short Add value to list..
      * @param value variable value
@@ -142,6 +283,14 @@ public:
         addValue(value);
     }
 
+    /**
+     * @short Add value to list..
+     * @param value variable value
+     */
+    void addStringValue(std::string &&value) {
+        addValue(std::move(value));
+    }
+
     /**
      * @short Add value to list..
      * @param value variable value
@@ -196,32 +345,54 @@ public:
     /**
      * @short Returns true if list is empty.
      */
-    bool empty() const {return items.empty();}
+    bool empty() const {return size() == 0;}
 
     /**
-     * @short Returns iterator to first fragment item.
+     * @short Returns the columns of columnar list or nullptr.
+     */
+    const FragmentColumns_t *columns() const {
+        return table? &table->columns: nullptr;
+    }
+
+    /**
+     * @short Returns copy of the columnar list converted to list of
+     * fragments.
+     */
+    FragmentList_t materialized() const;
+
+    /**
+     * @short Returns the memory resource the list is allocated from.
+     */
+    Resource_t *resource() const {return items.get_allocator().resource();}
+
+    /**
+     * @short Returns iterator to first fragment item. The fragments of
+     * columnar list are built from the columns on the first const access.
      */
-    const_iterator begin() const {return items.begin();}
+    const_iterator begin() const {return const_items().begin();}
 
     /**
      * @short Returns iterator one past the last fragment item.
      */
-    const_iterator end() const {return items.end();}
+    const_iterator end() const {return const_items().end();}
 
     /**
      * @short Returns iterator to first fragment item.
      */
-    iterator begin() {return items.begin();}
+    iterator begin() {materialize(); return items.begin();}
 
     /**
      * @short Returns iterator one past the last fragment item.
      */
-    iterator end() {return items.end();}
+    iterator end() {materialize(); return items.end();}
 
     /**
-     * @short Returns i-th fragment in the list.
+     * @short Returns i-th fragment in the list. The fragments of columnar
+     * list are built from the columns on the first const access.
      */
-    const FragmentValue_t &operator[](size_type i) const;
+    const FragmentValue_t &operator[](size_type i) const {
+        return const_items()[i];
+    }
 
     /**
      * @short Returns i-th fragment in the list.
@@ -229,7 +400,38 @@ public:
     FragmentValue_t &operator[](size_type i);
 
 protected:
-    Items_t items; //!< the fragment list items
+    /** Converts the columnar list to list of fragments.
+     */
+    void materialize() {if (table) materialize_columns();}
+
+    /** Converts the columnar list to list of fragments.
+     */
+    void materialize_columns();
+
+    /** Returns the items or the fragments built from the columns of
+     * columnar list.
+     */
+    const Items_t &const_items() const {return table? table_items(): items;}
+
+    /** Returns the fragments built from the columns, they are built by the
+     * first call.
+     */
+    const Items_t &table_items() const;
+
+    /** The columns of columnar list and the fragments built from them for
+     * const access.
+     */
+    struct Table_t {
+        explicit Table_t(FragmentColumns_t &&columns)
+            : columns(std::move(columns))
+        {}
+        FragmentColumns_t columns; //!< the columns of values
+        std::once_flag built;      //!< the fragments are built once
+        Items_t items;             //!< the fragments built from columns
+    };
+
+    Items_t items;                  //!< the fragment list items
+    std::unique_ptr<Table_t> table; //!< the columnar list
 };
 
 /** Writes string representation of fragment value list to stream.
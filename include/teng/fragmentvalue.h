@@ -74,9 +74,11 @@ public:
     FragmentValue_t(FragmentValue_t &&other) noexcept;
 
     /**
-     * @short Assigment: move.
+     * @short Assigment: move. It may allocate (and throw) if the fragments
+     * or the fragment lists of both values are allocated from different
+     * memory resources.
      */
-    FragmentValue_t &operator=(FragmentValue_t &&other) noexcept;
+    FragmentValue_t &operator=(FragmentValue_t &&other);
 
     /**
      * @short Create new scalar value with given value.
@@ -115,12 +117,27 @@ public:
         : tag_value(tag::list), list_value(std::move(value))
     {}
 
+    /**
+     * @short Create value that refers to shared immutable fragment. The
+     * fragment is not copied, it is kept alive as long as the value exists.
+     */
+    explicit FragmentValue_t(std::shared_ptr<const Fragment_t> value) noexcept
+        : tag_value(tag::frag_ptr), frag_ptr_value(std::move(value))
+    {}
+
     /** C'tor.
      */
     explicit FragmentValue_t(TypeTag_t<Fragment_t>) noexcept
         : tag_value(tag::frag), frag_value()
     {}
 
+    /**
+     * @short Create empty fragment value allocated from resource.
+     */
+    FragmentValue_t(TypeTag_t<Fragment_t>, Fragment_t::Resource_t *resource)
+        : tag_value(tag::frag), frag_value(resource)
+    {}
+
     /**
      * @short Create empty fragment list value.
      */
@@ -128,6 +145,15 @@ public:
         : tag_value(tag::list), list_value()
     {}
 
+    /**
+     * @short Create empty fragment list value allocated from resource.
+     */
+    FragmentValue_t(
+        TypeTag_t<FragmentList_t>,
+        FragmentList_t::Resource_t *resource
+    ): tag_value(tag::list), list_value(resource)
+    {}
+
     /**
      * @short Destroy value.
      */
@@ -251,7 +277,7 @@ public:
     const Fragment_t *fragment() const {
         switch (tag_value) {
         case tag::frag: return &frag_value;
-        case tag::frag_ptr: return frag_ptr_value;
+        case tag::frag_ptr: return frag_ptr_value.get();
         default: return nullptr;
         }
     }
@@ -269,22 +295,27 @@ protected:
      * @param value value of variable
      */
     explicit FragmentValue_t(const Fragment_t *frag_ptr_value) noexcept
-        : tag_value(tag::frag_ptr), frag_ptr_value(frag_ptr_value)
+        : tag_value(tag::frag_ptr),
+          frag_ptr_value(std::shared_ptr<const Fragment_t>(), frag_ptr_value)
     {}
 
     /**
      * @short Ensures that value is fragment list and if not then other value
      * is destroyed and new empty fragment list is assigned to value and
-     * returned.
+     * returned. The new list is allocated from given resource.
      */
-    FragmentList_t &ensureFragmentList();
+    FragmentList_t &ensureFragmentList(
+        FragmentList_t::Resource_t *resource = std::pmr::get_default_resource()
+    );
 
     /**
      * @short Ensures that value is fragment and if not then other value
      * is destroyed and new empty fragment is assigned to value and
-     * returned.
+     * returned. The new fragment is allocated from given resource.
      */
-    Fragment_t &ensureFragment();
+    Fragment_t &ensureFragment(
+        Fragment_t::Resource_t *resource = std::pmr::get_default_resource()
+    );
 
     tag tag_value; //!< the type of value
     union {
@@ -293,7 +324,8 @@ protected:
         double real_value;           //!< real number (scalar) value
         FragmentList_t list_value;   //!< list of nested fragment values
         Fragment_t frag_value;       //!< data fragment
-        const Fragment_t *frag_ptr_value; //!< for data root
+        //! for data root (not owned) and shared fragments (owned)
+        std::shared_ptr<const Fragment_t> frag_ptr_value;
     };
 };
 
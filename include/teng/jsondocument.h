@@ -0,0 +1,121 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- data tree backed by JSON document.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGJSONDOCUMENT_H
+#define TENGJSONDOCUMENT_H
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include <teng/datasource.h>
+
+namespace Teng {
+
+/** Read-only JSON document that can be rendered without converting it to
+ * Fragment_t by hand. The document is parsed once into compact tape of nodes,
+ * the template is then rendered directly from the tape (see DataSource_t).
+ * The string values are references to the text of the document, the escape
+ * sequences are decoded in place during the parse, so nothing is copied to
+ * the heap. The keys of each object are sorted during the parse and looked up
+ * by binary search, the items of arrays are indexed.
+ *
+ * The JSON values are mapped to the template values this way:
+ *
+ * object - fragment,
+ * array - fragment list (of fragments, lists or scalar values),
+ * string - string value,
+ * number - integral value if it is integer and fits, real value otherwise,
+ * true/false - integral value 1/0,
+ * null - undefined value (empty string if it is array item).
+ *
+ * The escaped lone UTF-16 surrogates are replaced by U+FFFD. If the object
+ * has duplicate keys the first one is used.
+ *
+ * Example:
+ *
+ * Teng::JsonDocument_t doc(R"({"title": "list", "row": [{"id": 1}]})");
+ * teng.generatePage(args, doc, writer, err);
+ */
+class JsonDocument_t: public DataSource_t {
+public:
+    // types
+    struct Document_t;
+
+    /** C'tor: parses the JSON document. The root value has to be object.
+     * @param json the document text
+     * @throw std::runtime_error if document is not valid JSON
+     */
+    explicit JsonDocument_t(std::string json);
+
+    /** Returns fragment that represents the root object of document.
+     */
+    Value_t root() const override;
+
+    /** Returns the value of the object key.
+     */
+    Value_t
+    attr(const DataNode_t &frag, const string_view_t &name) const override;
+
+    /** Returns the number of array items.
+     */
+    std::size_t size(const DataNode_t &list) const override;
+
+    /** Returns the i-th array item.
+     */
+    Value_t item(const DataNode_t &list, std::size_t i) const override;
+
+    /** Calls the visitor for each key of object in sorted order.
+     */
+    void
+    visit(const DataNode_t &frag, const Visitor_t &visitor) const override;
+
+    /** Returns the number of nodes of the parsed document.
+     */
+    std::size_t size() const;
+
+private:
+    /** Returns the value of the node.
+     */
+    Value_t value(uint32_t node) const;
+
+    std::shared_ptr<const Document_t> doc; //!< the text and its tape
+};
+
+} // namespace Teng
+
+#endif /* TENGJSONDOCUMENT_H */
@@ -0,0 +1,127 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- source level profile of rendered templates.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGPROFILE_H
+#define TENGPROFILE_H
+
+#include <map>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+namespace Teng {
+
+/** @short Source level profile of rendered templates.
+ *
+ * The executed instructions and the elapsed time are attributed to the
+ * stack of open fragments and called blocks and to the template line the
+ * instruction has been generated from. The profile accumulates all renders
+ * it has been passed to (see Teng_t::GenPageArgs_t::profile).
+ *
+ * The instruction counts are exact. The time is sampled: roughly one of 64
+ * instructions is timed and its time is multiplied by 64, so the time of
+ * a line is an estimate that becomes accurate for lines executing many
+ * instructions. The profiled render is still slower than the regular one.
+ *
+ * The profile is not synchronized: one instance must not be passed to
+ * renders running concurrently in more threads, use one profile per
+ * thread instead.
+ */
+class Profile_t {
+public:
+    /** @short The metric written to collapsed stacks.
+     */
+    enum class Metric_t {INSTRUCTIONS, TIME};
+
+    /** @short Counters of one template line in one stack.
+     */
+    struct Entry_t {
+        std::string stack;         //!< fragments and blocks joined by ';'
+        std::string filename;      //!< the template file
+        int64_t lineno = 0;        //!< the line in template file
+        uint64_t instructions = 0; //!< the number of executed instructions
+        uint64_t time = 0;         //!< the elapsed time in nanoseconds
+    };
+
+    /** @short Adds counters to the entry of given stack and line.
+     */
+    void add(
+        const std::string &stack,
+        const std::string &filename,
+        int64_t lineno,
+        uint64_t instructions,
+        uint64_t time
+    );
+
+    /** @short Returns all entries of the profile.
+     */
+    std::vector<Entry_t> entries() const;
+
+    /** @short Writes the profile as collapsed stacks, one line per entry:
+     *  "root;frag;block name;file:line value", that flamegraph tools
+     *  accept.
+     *  @param os output stream
+     *  @param metric the value of the stack
+     */
+    void collapsed(std::ostream &os, Metric_t metric = Metric_t::TIME) const;
+
+    /** @short Returns true if nothing has been profiled.
+     */
+    bool empty() const {return counters.empty();}
+
+    /** @short Discards the profile.
+     */
+    void clear() {counters.clear();}
+
+private:
+    /** The counters of one entry.
+     */
+    struct Counters_t {
+        uint64_t instructions = 0; //!< the number of executed instructions
+        uint64_t time = 0;         //!< the elapsed time in nanoseconds
+    };
+
+    using Key_t = std::tuple<std::string, std::string, int64_t>;
+    std::map<Key_t, Counters_t> counters; //!< stack and line to counters
+};
+
+} // namespace Teng
+
+#endif /* TENGPROFILE_H */
+
@@ -45,12 +45,17 @@
 
 #include <teng/writer.h>
 #include <teng/error.h>
+#include <teng/cachestats.h>
+#include <teng/compilereport.h>
+#include <teng/tracer.h>
+#include <teng/datasource.h>
 #include <teng/fragmentvalue.h>
 
 namespace Teng {
 
 // forwards
 class FilesystemInterface_t;
+class Profile_t;
 
 
 /** @short Templating engine.
@@ -66,8 +71,35 @@ public:
         // NOTE(burlog): zero is replaced by default size (50) in Cache_t
         uint32_t programCacheSize; //!< the max number of cached templates
         uint32_t dictCacheSize;    //!< the max number of cached dicts
+        bool collectStats = false; //!< collect render stats of templates
+        CacheCallback_t cacheCallback; //!< called on cache load/eviction
+        std::shared_ptr<Tracer_t> tracer; //!< receives render phases
     };
 
+    /** @short Render statistics of one cached template (program). The
+     *  times are in nanoseconds and the percentiles are computed from the
+     *  last STATS_WINDOW renders.
+     */
+    struct TemplateStats_t {
+        std::string source;           //!< template filename or md5 of string
+        std::string dictFilename;     //!< the language dictionary
+        std::string paramsFilename;   //!< the config dictionary
+        std::string contentType;      //!< the content type
+        uint64_t renders = 0;         //!< the number of renders
+        uint64_t renderTime = 0;      //!< the cumulative render time
+        uint64_t renderTimeP50 = 0;   //!< the median of render time
+        uint64_t renderTimeP99 = 0;   //!< the 99th percentile of render time
+        uint64_t bytes = 0;           //!< the cumulative size of output
+        uint64_t instructions = 0;    //!< the executed instructions
+        uint64_t compiles = 0;        //!< the number of compilations
+        uint64_t compileTime = 0;     //!< the cumulative compile time
+    };
+
+    /** @short The number of recent renders the percentiles are computed
+     *  from.
+     */
+    static constexpr std::size_t STATS_WINDOW = 256;
+
     /** @short Create new engine.
      *  @param fs_root root of relative paths
      *  @param settings teng options
@@ -101,6 +133,8 @@ public:
         std::string lang = "";
         std::string encoding = "utf-8";
         std::string contentType = "text/html";
+        bool reserveOutput = false; //!< reserve writer space for the page
+        Profile_t *profile = nullptr; //!< collects profile of the render
     };
 
     /** @short Generate page from file template.
@@ -116,6 +150,21 @@ public:
         Error_t &err
     ) const;
 
+    /** @short Generate page from file template. The data are read from the
+     *  data source as the template accesses them.
+     * @param args The arguments structure.
+     * @param data the source of data tree
+     * @param writer output writer (page destinatin)
+     * @param err error log
+     * @return 0 OK, !0 error
+     */
+    int generatePage(
+        const GenPageArgs_t &args,
+        const DataSource_t &data,
+        Writer_t &writer,
+        Error_t &err
+    ) const;
+
     /** @short Generate page from file template.
      *  @param templateFilename file with main template
      *  @param skin skin of template
@@ -196,6 +245,35 @@ public:
         );
     }
 
+    /** @short Returns the render statistics of templates collected since
+     *  the engine creation or the last reset. It's empty unless the
+     *  Settings_t::collectStats is set.
+     */
+    std::vector<TemplateStats_t> templateStats() const;
+
+    /** @short Discards collected render statistics of templates.
+     */
+    void resetTemplateStats();
+
+    /** @short Returns the counters of the template and dictionary caches
+     *  collected since the engine creation or the last reset and the
+     *  estimated heap footprint of the cached entries. The footprint of each
+     *  entry is computed once, so it's cheap to export it as a gauge.
+     */
+    CachesStats_t cacheStats() const;
+
+    /** @short Resets the counters of the caches.
+     */
+    void resetCacheStats();
+
+    /** @short Returns the compile report of the cached template given by
+     *  args. The template is neither compiled nor loaded and the cache
+     *  counters are not touched, so the report is empty if the template
+     *  hasn't been rendered yet (or has been evicted) or if the
+     *  compilereport feature is disabled in the params file.
+     */
+    CompileReport_t compileReport(const GenPageArgs_t &args) const;
+
     /** @short Find entry in dictionary.
      *  @param params params dictionary path
      *  @param dict language dictionary path
@@ -0,0 +1,96 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng tracing hooks.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGTRACER_H
+#define TENGTRACER_H
+
+#include <string>
+
+namespace Teng {
+
+/** @short Receives the begin and the end of each render phase, so the time
+ * spent in Teng can be correlated with the spans of request traces. The
+ * phases can nest (the compilation runs inside the cache lookup and the
+ * loads of files inside the compilation) and each begin is paired with
+ * exactly one end even if the phase fails. The methods are called from
+ * the rendering thread and they must not throw.
+ */
+class Tracer_t {
+public:
+    /** The traced phases.
+     */
+    enum Phase_t {
+        CACHE_LOOKUP, //!< lookup of template and dictionaries in caches
+        COMPILE,      //!< compilation of template into program
+        LOAD,         //!< read of template file (main, included or extended)
+        EXECUTE,      //!< execution of program
+        FLUSH,        //!< flush of writer
+    };
+
+    /** D'tor.
+     */
+    virtual ~Tracer_t() = default;
+
+    /** @short Called when the phase begins.
+     *  @param phase the phase
+     *  @param detail the template filename (empty for template strings)
+     */
+    virtual void begin(Phase_t phase, const std::string &detail) = 0;
+
+    /** @short Called when the phase ends.
+     *  @param phase the phase
+     */
+    virtual void end(Phase_t phase) = 0;
+
+    /** @short Returns the name of the phase.
+     */
+    static const char *name(Phase_t phase) {
+        switch (phase) {
+        case CACHE_LOOKUP: return "cache-lookup";
+        case COMPILE: return "compile";
+        case LOAD: return "load";
+        case EXECUTE: return "execute";
+        case FLUSH: return "flush";
+        }
+        return "unknown";
+    }
+};
+
+} // namespace Teng
+
+#endif /* TENGTRACER_H */
+
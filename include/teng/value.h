@@ -41,6 +41,7 @@
 #define TENGVALUE_H
 
 #include <string>
+#include <cstdint>
 #include <stdexcept>
 
 #include <teng/stringify.h>
@@ -54,11 +55,33 @@ class Regex_t;
 class Fragment_t;
 class FragmentList_t;
 class FragmentValue_t;
+class DataSource_t;
 
 /** The type of undefined value.
  */
 struct Undefined_t {};
 
+/** Reference to fragment or list of data tree. The nodes of the native data
+ * tree have no source and the ptr points to Fragment_t or FragmentList_t. The
+ * nodes of other trees are interpreted by their data source (see
+ * DataSource_t), the meaning of ptr and id is up to the source.
+ */
+struct DataNode_t {
+    /** Returns true if node references something.
+     */
+    explicit operator bool() const {return source || ptr;}
+
+    const DataSource_t *source; //!< the source of node or nullptr
+    const void *ptr;            //!< the node data
+    uint64_t id;                //!< the node id within the source
+};
+
+/** Comparison operator.
+ */
+inline bool operator==(const DataNode_t &lhs, const DataNode_t &rhs) {
+    return lhs.source == rhs.source && lhs.ptr == rhs.ptr && lhs.id == rhs.id;
+}
+
 /** Variant like class for Teng values that can hold numeric and string value.
  */
 class Value_t {
@@ -69,8 +92,21 @@ public:
     using real_type = double;
     using string_type = std::string;
     using string_ref_type = string_view_t;
-    struct frag_ref_type {const Fragment_t *ptr;};
-    struct list_ref_type {const FragmentList_t *ptr; std::size_t i;};
+    struct frag_ref_type: DataNode_t {
+        /** Returns the native fragment or nullptr.
+         */
+        const Fragment_t *frag() const {
+            return source? nullptr: static_cast<const Fragment_t *>(ptr);
+        }
+    };
+    struct list_ref_type: DataNode_t {
+        /** Returns the native fragment list or nullptr.
+         */
+        const FragmentList_t *list() const {
+            return source? nullptr: static_cast<const FragmentList_t *>(ptr);
+        }
+        std::size_t i; //!< the index of current item
+    };
     using regex_type = counted_ptr<Regex_t>;
 
     /** Tags of all possible held value types.
@@ -139,13 +175,25 @@ public:
     /** C'tor: fragment value.
      */
     explicit Value_t(const Fragment_t *value) noexcept
-        : tag_value(tag::frag_ref), frag_ref_value({value})
+        : tag_value(tag::frag_ref), frag_ref_value({{nullptr, value, 0}})
     {}
 
     /** C'tor: fragment value.
      */
     explicit Value_t(const FragmentList_t *value, std::size_t i = 0) noexcept
-        : tag_value(tag::list_ref), list_ref_value({value, i})
+        : tag_value(tag::list_ref), list_ref_value({{nullptr, value, 0}, i})
+    {}
+
+    /** C'tor: fragment node of data source.
+     */
+    explicit Value_t(const frag_ref_type &value) noexcept
+        : tag_value(tag::frag_ref), frag_ref_value(value)
+    {}
+
+    /** C'tor: list node of data source.
+     */
+    explicit Value_t(const list_ref_type &value) noexcept
+        : tag_value(tag::list_ref), list_ref_value(value)
     {}
 
     /** C'tor: fragment value.
@@ -599,9 +647,9 @@ public:
         case tag::string_ref:
             return !string_ref_value.empty();
         case tag::frag_ref:
-            return frag_ref_value.ptr;
+            return bool(frag_ref_value);
         case tag::list_ref:
-            return list_ref_value.ptr;
+            return bool(list_ref_value);
         case tag::regex:
             return true;
         }
@@ -762,11 +810,11 @@ protected:
             static const string_view_t null = "$null$";
             static const string_view_t frag = "$frag$";
             static const visited_type<tag::frag_ref> tag_frag_ref;
-            return visitor(self.frag_ref_value.ptr? frag: null, tag_frag_ref);
+            return visitor(self.frag_ref_value? frag: null, tag_frag_ref);
         case tag::list_ref:
             static const string_view_t list = "$list$";
             static const visited_type<tag::list_ref> tag_list_ref;
-            return visitor(self.list_ref_value.ptr? list: null, tag_list_ref);
+            return visitor(self.list_ref_value? list: null, tag_list_ref);
         case tag::regex:
             static const string_view_t regex = "$regex$";
             static const visited_type<tag::undefined> tag_regex;
@@ -826,10 +874,10 @@ inline bool operator==(const Value_t &lhs, const Value_t &rhs) {
         return lhs.string_ref_value == rhs.string();
     case Value_t::tag::frag_ref:
         return lhs.tag_value == rhs.tag_value
-            && lhs.frag_ref_value.ptr == rhs.frag_ref_value.ptr;
+            && lhs.frag_ref_value == rhs.frag_ref_value;
     case Value_t::tag::list_ref:
         return lhs.tag_value == rhs.tag_value
-            && lhs.list_ref_value.ptr == rhs.list_ref_value.ptr
+            && lhs.list_ref_value == rhs.list_ref_value
             && lhs.list_ref_value.i == rhs.list_ref_value.i;
     case Value_t::tag::regex:
         return lhs.tag_value == rhs.tag_value
@@ -106,6 +106,24 @@ public:
      */
     virtual int flush() = 0;
 
+    /** @short Hints the writer that approximately given number of bytes is
+     *  going to be written. Default implementation ignores the hint.
+     *  @param size expected number of bytes
+     */
+    virtual void reserve(std::size_t /*size*/) {}
+
+    /** @short Write literal of the template to output. Literals are known
+     *  at compile time and repeat in each page generated from the template
+     *  so the writer may cache data derived from them. Default
+     *  implementation writes them as any other string.
+     *  @param str literal to be written
+     *  @param size length of the literal
+     *  @return 0 OK, !0 error
+     */
+    virtual int writeLiteral(const char *str, std::size_t size) {
+        return write(str, size);
+    }
+
     /** @short Write given string to output.
      *  @param istr begin of string to be written
      *  @param estr end of string to be written
@@ -162,6 +180,12 @@ public:
      */
     int flush() override { return 0; }
 
+    /** @short Reserves space for given number of bytes in the associated
+     *  string.
+     *  @param size expected number of bytes
+     */
+    void reserve(std::size_t size) override;
+
 private:
     /** @short Associated string.
      */
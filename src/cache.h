@@ -45,9 +45,11 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 
 #include "util.h"
 #include "teng/error.h"
+#include "teng/cachestats.h"
 #include "sourcelist.h"
 
 namespace Teng {
@@ -185,6 +187,11 @@ public:
      */
     using LRU_t = CacheLRU_t<LRUEntry_t>;
 
+    /**
+     * @short Called with key of each evicted entry.
+     */
+    using Evicted_t = std::function<void (const Key_t &)>;
+
     /**
      * @short Creates empty cache.
      */
@@ -219,6 +226,20 @@ public:
         return {entry.data, entry.dependSerial, entry.serial};
     }
 
+    /**
+     * @short Returns the cached data or empty shared_ptr. Unlike find() it
+     * doesn't touch the lru.
+     *
+     * @param key searched key
+     * @return found data or empty shared_ptr
+     */
+    std::shared_ptr<Data_t> peek(const Key_t &key) const {
+        auto ientry = cache.find(key);
+        if (ientry == cache.end())
+            return {};
+        return ientry->second.data;
+    }
+
     /**
      * @short Adds new entry into cache.
      *
@@ -253,8 +274,12 @@ public:
         };
 
         // at first, if size of cache is greater then limit kill some entry
-        if (cache.size() >= maximalSize)
-            cache.erase(lru.popLeastRecentlyUsed(unused)->first);
+        if (cache.size() >= maximalSize) {
+            auto &victim = lru.popLeastRecentlyUsed(unused)->first;
+            ++counters.evictions;
+            if (evicted) evicted(victim);
+            cache.erase(victim);
+        }
 
         // emplace cache entry and update lru
         auto ientry = cache.emplace(key, Entry_t(data, dependSerial)).first;
@@ -288,6 +313,38 @@ public:
         return ++entry.serial;
     }
 
+    /**
+     * @short Returns the counters of the cache.
+     */
+    CacheStats_t &stats() {return counters;}
+
+    /**
+     * @short Returns the counters of the cache.
+     */
+    const CacheStats_t &stats() const {return counters;}
+
+    /**
+     * @short Returns the estimated heap footprint of the cache entries
+     * including the cached data.
+     */
+    std::size_t memoryUsage() const {
+        // the tree node holds the entry, three pointers and the color
+        auto node_size = sizeof(typename EntryCache_t::value_type)
+                       + 4 * sizeof(void *);
+        std::size_t size = 0;
+        for (auto &entry: cache) {
+            size += node_size + entry.second.data->memoryUsage();
+            for (auto &part: entry.first)
+                size += sizeof(part) + heap_size(part);
+        }
+        return size;
+    }
+
+    /**
+     * @short Sets the callback called on each eviction.
+     */
+    void onEvicted(Evicted_t callback) {evicted = std::move(callback);}
+
 private:
     // don't copy
     Cache_t(const Cache_t &) = delete;
@@ -296,6 +353,8 @@ private:
     EntryCache_t cache;        //!< the cache
     mutable LRU_t lru;         //!< LRU for cache entries
     unsigned int maximalSize;  //!< Maximal size of cache.
+    CacheStats_t counters;     //!< the counters of the cache
+    Evicted_t evicted;         //!< called on each eviction
 };
 
 } // namespace Teng
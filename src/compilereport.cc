@@ -0,0 +1,70 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- the timing breakdown of template compilation.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <iomanip>
+
+#include "teng/compilereport.h"
+
+namespace Teng {
+
+std::ostream &operator<<(std::ostream &os, const CompileReport_t &report) {
+    auto ms = [] (uint64_t ns) {return double(ns) / 1e6;};
+    auto flags = os.flags();
+    os << std::fixed << std::setprecision(3)
+       << "Compile report:" << std::endl
+       << "    total: " << ms(report.totalTime) << "ms" << std::endl
+       << "    lex1: " << ms(report.lex1Time) << "ms, "
+       << report.lex1Tokens << " tokens" << std::endl
+       << "    lex2: " << ms(report.lex2Time) << "ms, "
+       << report.lex2Tokens << " tokens" << std::endl
+       << "    parse: " << ms(report.parseTime) << "ms, "
+       << report.instructions << " instructions" << std::endl
+       << "    eval: " << ms(report.evalTime) << "ms, "
+       << report.evalSuccesses << "/" << report.evalAttempts
+       << " folded" << std::endl
+       << "    read: " << ms(report.readTime) << "ms, "
+       << report.files << " files, " << report.fileBytes << " bytes"
+       << std::endl
+       << "    reparse: " << report.reparses << " sources, "
+       << report.reparsedBytes << " bytes" << std::endl
+       << "    finish: " << ms(report.finishTime) << "ms" << std::endl;
+    os.flags(flags);
+    return os;
+}
+
+} // namespace Teng
+
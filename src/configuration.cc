@@ -48,7 +48,8 @@ Configuration_t::Configuration_t(Error_t &err, std::shared_ptr<const FilesystemI
     : Dictionary_t(err, filesystem),
       debug(false), errorFragment(false), logToOutput(false), bytecode(false),
       watchFiles(true), alwaysEscape(true), shortTag(false), format(true),
-      maxIncludeDepth(10), maxDebugValLength(40), printEscape(true)
+      maxIncludeDepth(10), maxDebugValLength(40), printEscape(true),
+      compileReport(false), execProfile(false)
 {}
 
 teng_feature
@@ -67,6 +68,8 @@ Configuration_t::isEnabled(const string_view_t &name) const {
     if (name == "alwaysescape") return bool2feature(alwaysEscape);
     if (name == "printescape") return bool2feature(printEscape);
     if (name == "shorttag") return bool2feature(shortTag);
+    if (name == "compilereport") return bool2feature(compileReport);
+    if (name == "execprofile") return bool2feature(execProfile);
 
     // unknown features
     return teng_feature::unknown;
@@ -85,7 +88,9 @@ std::ostream &operator<<(std::ostream &o, const Configuration_t &c) {
       << "    format: " << bool2string(c.format) << std::endl
       << "    alwaysescape: " << bool2string(c.alwaysEscape) << std::endl
       << "    printescape: " << bool2string(c.printEscape) << std::endl
-      << "    shorttag: " << bool2string(c.shortTag) << std::endl;
+      << "    shorttag: " << bool2string(c.shortTag) << std::endl
+      << "    compilereport: " << bool2string(c.compileReport) << std::endl
+      << "    execprofile: " << bool2string(c.execProfile) << std::endl;
     return o;
 }
 
@@ -129,6 +134,8 @@ Configuration_t::new_directive(
         if (value == "alwaysescape") return do_enable(alwaysEscape);
         if (value == "printescape") return do_enable(printEscape);
         if (value == "shorttag") return do_enable(shortTag);
+        if (value == "compilereport") return do_enable(compileReport);
+        if (value == "execprofile") return do_enable(execProfile);
         return enable? error_code::invalid_enable: error_code::invalid_disable;
     };
 
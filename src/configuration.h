@@ -73,6 +73,8 @@ public:
     bool isAlwaysEscapeEnabled() const {return alwaysEscape;}
     bool isPrintEscapeEnabled() const {return printEscape;}
     bool isShortTagEnabled() const {return shortTag;}
+    bool isCompileReportEnabled() const {return compileReport;}
+    bool isExecProfileEnabled() const {return execProfile;}
     // @}
 
     /** Sets enabled to true if feature is enabled.
@@ -83,6 +85,13 @@ public:
      */
     friend std::ostream &operator<<(std::ostream &o, const Configuration_t &c);
 
+    /** Returns the estimated heap footprint of the configuration.
+     */
+    std::size_t memoryUsage() const override {
+        return Dictionary_t::memoryUsage()
+             + sizeof(Configuration_t) - sizeof(Dictionary_t);
+    }
+
 protected:
     /** Called wheb new directive parsed.
      */
@@ -103,6 +112,8 @@ protected:
     uint32_t maxIncludeDepth;   //!< maximal template include depth
     uint16_t maxDebugValLength; //!< maximal length of variable value length
     bool printEscape;  //!< use escaping only if values are printed
+    bool compileReport; //!< collect compile report of templates (false)
+    bool execProfile;   //!< count executions of instructions (false)
 };
 
 } // namespace Teng
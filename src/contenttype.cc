@@ -38,6 +38,7 @@
 #include <iomanip>
 #include <cstring>
 #include <utility>
+#include <iterator>
 #include <algorithm>
 
 #include "contenttype.h"
@@ -157,104 +158,17 @@ ContentType_t::Descriptor_t *init_descriptors() {
 
 ContentType_t::Descriptor_t *unknown = init_descriptors();
 
-/**
- * @short State in unescaper automaton.
- */
-struct UnescaperState_t {
-    /**
-     * @short Vector of next states.
-     */
-    using UnescaperStateVector_t = std::vector<UnescaperState_t>;
-    using Pairs_t = std::vector<std::pair<int64_t, int64_t>>;
-
-    /**
-     * @short Create new state.
-     * @param rule matched character
-     */
-    UnescaperState_t(int rule = 0)
-        : rule(rule), nextState(0)
-    {}
-
-    /**
-     * @short Matched character.
-     */
-    int rule;
-
-    /**
-     * @short Next state of automaton (positive) or replacement
-     *        character (negative) or stop state (zero).
-     */
-    int64_t nextState;
-
-    /**
-     * @short Next states.
-     */
-    UnescaperStateVector_t nextStates;
-
-    /**
-     * @short Add new next state.
-     * @param o rule for new state
-     * @return added state
-     */
-    UnescaperState_t &add(int o) {
-        // try to find existing state
-        for (auto &state: nextStates)
-            if (state.rule == o)
-                return state;
-
-        // no state found, create it
-        nextStates.push_back(UnescaperState_t(o));
-
-        // return it
-        return nextStates.back();
-    }
-
-    /**
-     * @short Linearize automaton tree.
-     */
-    void linearize(Pairs_t &unescaper) const {
-        // remember link holders
-        std::vector<std::size_t> referrers;
-
-        // run throgh next states and write rule for each
-        for (auto &state: nextStates) {
-            // remember position of link to next state
-            referrers.push_back(unescaper.size());
-            unescaper.emplace_back(state.rule, -state.nextState);
-        }
-
-        // put STOP indicator when we have any next state
-        if (nextState == 0)
-            unescaper.emplace_back(0, 0);
-
-        // run through all rules
-        auto ireferrers = referrers.begin();
-        for (auto &state: nextStates) {
-            if (!state.nextState) {
-                // remember start of next state
-                std::size_t pos = unescaper.size();
-                // linearize this state
-                state.linearize(unescaper);
-                // assign link to sub state
-                unescaper[*ireferrers].second = pos;
-            }
-            ++ireferrers;
-        }
-    }
-};
-
 } // namespace
 
 ContentType_t::ContentType_t()
-    : lineComment(), blockComment(), escapes(), unescaper()
+    : lineComment(), blockComment(), kernel(KERNEL_TABLE), escapes(),
+      unescapes()
 {
     // set escape bitmap to all -1 (character not escaped)
-    auto *end = escapeBitmap + 256;
-    auto *i = escapeBitmap;
-    while (i != end) *i++ = -1;
+    std::fill(std::begin(escapeBitmap), std::end(escapeBitmap), -1);
 
-    // create empty automaton
-    unescaper.emplace_back(0, 0);
+    // set unescape bitmap to all -1 (no escape sequence)
+    std::fill(std::begin(unescapeBitmap), std::end(unescapeBitmap), -1);
 }
 
 int64_t ContentType_t::addEscape(unsigned char c, const std::string &escape) {
@@ -269,6 +183,13 @@ int64_t ContentType_t::addEscape(unsigned char c, const std::string &escape) {
 }
 
 std::string ContentType_t::escape(const string_view_t &src) const {
+    // use specialized kernels if available
+    switch (kernel) {
+    case KERNEL_HTML: return escape_string<HtmlEscaping_t>(src);
+    case KERNEL_JS: return escape_string<JsEscaping_t>(src);
+    case KERNEL_TABLE: break;
+    }
+
     // output string
     std::string dest;
     dest.reserve(src.size());
@@ -293,73 +214,67 @@ std::string ContentType_t::unescape(const string_view_t &src) const {
     dest.reserve(src.size());
 
     // run through input string
-    for (auto isrc = src.begin(); isrc != src.end();) {
-        // help iterator
-        auto bsrc = isrc;
-        // index in automaton
-        int64_t state = 0;
-        // run through remaining characters
-        for (; bsrc != src.end(); ++bsrc) {
-            // move to next state
-            state = nextState(*bsrc, state);
-            // we stop here if state is not positive
-            if (state <= 0) break;
+    for (auto isrc = src.begin(), esrc = src.end(); isrc != esrc;) {
+        // pass characters that can't start escape sequence verbatim to output
+        auto irun = isrc;
+        while ((isrc != esrc) && !canStartEscape(*isrc)) ++isrc;
+        dest.append(irun, isrc);
+        if (isrc == esrc) break;
+
+        // try all sequences starting with current character
+        auto len = std::size_t(0);
+        auto rest = static_cast<std::size_t>(esrc - isrc);
+        auto pos = unescapeBitmap[static_cast<unsigned char>(*isrc)];
+        for (; std::size_t(pos) < unescapes.size(); ++pos) {
+            auto &sequence = unescapes[pos].first;
+            if (sequence.front() != *isrc) break;
+            if (sequence.size() > rest) continue;
+            if (!std::memcmp(isrc, sequence.data(), sequence.size())) {
+                dest.push_back(unescapes[pos].second);
+                len = sequence.size();
+                break;
+            }
         }
 
-        // check final state
-        if (state < 0) {
-            // state is negative => it's negated character!
-            dest.push_back(static_cast<char>(-state));
-            // move after so far eaten escape sequence
-            isrc = bsrc + 1;
-        } else {
-            // sequence not matcher pass input verbatim to output
-            dest.push_back(*isrc++);
-        }
+        // move after so far eaten escape sequence or pass input verbatim
+        if (len) isrc += len;
+        else dest.push_back(*isrc++);
     }
+
     // return output
     return dest;
 }
 
-int64_t ContentType_t::nextState(unsigned char c, int64_t state) const {
-    // stop when state outside automaton
-    if ((std::size_t(state) >= unescaper.size()) || (state < 0))
-        return 0;
-
-    // find rule to move to next state
-    for (auto i = unescaper.begin() + state; i->first > 0; ++i)
-        if (i->first == c)
-            return i->second;
-
-    // no rule => stop
-    return 0;
-}
-
 void ContentType_t::compileUnescaper() {
-    // destroy current automaton
-    unescaper.clear();
-
-    // start state of automaton
-    UnescaperState_t root;
+    // destroy current table
+    unescapes.clear();
+    std::fill(std::begin(unescapeBitmap), std::end(unescapeBitmap), -1);
 
     // run through escape definitions
     for (auto &escape: escapes) {
-        // start state
-        UnescaperState_t *state = &root;
-
-        // escape sequence
-        const std::string &str = escape.second;
+        // the NUL character has never been unescaped
+        if (escape.first == '\0') continue;
+        if (escape.second.empty()) continue;
+        unescapes.emplace_back(escape.second, static_cast<char>(escape.first));
+    }
 
-        // run through escape sequence
-        for (char ch: str)
-            state = &state->add(ch);
+    // group sequences by the first character, the shortest one wins
+    std::stable_sort(
+        unescapes.begin(),
+        unescapes.end(),
+        [] (const auto &lhs, const auto &rhs) {
+            auto lhs_ch = static_cast<unsigned char>(lhs.first.front());
+            auto rhs_ch = static_cast<unsigned char>(rhs.first.front());
+            if (lhs_ch != rhs_ch) return lhs_ch < rhs_ch;
+            return lhs.first.size() < rhs.first.size();
+        }
+    );
 
-        // assign unescaped character as final rule
-        state->nextState = escape.first;
+    // note where the sequences for each first character start
+    for (auto i = unescapes.size(); i-- > 0;) {
+        auto ch = static_cast<unsigned char>(unescapes[i].first.front());
+        unescapeBitmap[ch] = i;
     }
-
-    // linearize automaton into vector
-    root.linearize(unescaper);
 }
 
 /** @short Create descriptor of HTML/XHTML/XML content type.
@@ -377,8 +292,9 @@ std::unique_ptr<ContentType_t> htmlCreator() {
     html->addEscape('<', "&lt;");
     html->addEscape('>', "&gt;");
     html->addEscape('"', "&quot;");
+    html->kernel = ContentType_t::KERNEL_HTML;
 
-    // compile unescaping automaton
+    // compile unescaping table
     html->compileUnescaper();
     return html;
 }
@@ -427,7 +343,7 @@ std::unique_ptr<ContentType_t> qstringCreator() {
     qs->addEscape('\'', "\\'");
     qs->addEscape('"', "\\\"");
 
-    // compile unescaping automaton
+    // compile unescaping table
     qs->compileUnescaper();
 
     // return descriptor
@@ -453,7 +369,7 @@ std::unique_ptr<ContentType_t> jshtmlCreator() {
     jshtml->addEscape('<', "&lt;");
     jshtml->addEscape('>', "&gt;");
 
-    // compile unescaping automaton
+    // compile unescaping table
     jshtml->compileUnescaper();
 
     // return descriptor
@@ -476,8 +392,9 @@ std::unique_ptr<ContentType_t> jsCreator() {
     js->addEscape('\'', "\\'");
     js->addEscape('"', "\\\"");
     js->addEscape('/', "\\/");
+    js->kernel = ContentType_t::KERNEL_JS;
 
-    // compile unescaping automaton
+    // compile unescaping table
     js->compileUnescaper();
 
     // return descriptor
@@ -504,7 +421,7 @@ std::unique_ptr<ContentType_t> jsonCreator() {
         js->addEscape(i, ss.str());
     }
 
-    // compile unescaping automaton
+    // compile unescaping table
     js->compileUnescaper();
 
     // return descriptor
@@ -528,6 +445,14 @@ ContentType_t::find(const string_view_t &name_view) {
         : idescriptor->second.get();
 }
 
+const ContentType_t::Descriptor_t *
+ContentType_t::find(const ContentType_t *contentType) {
+    for (auto *descriptor: descriptorIndex)
+        if (descriptor->contentType.get() == contentType)
+            return descriptor;
+    return nullptr;
+}
+
 std::vector<std::pair<std::string, std::string>>
 ContentType_t::listSupported() {
     std::vector<std::pair<std::string, std::string>> result;
@@ -57,6 +57,15 @@ namespace Teng {
  */
 class ContentType_t {
 public:
+    /** @short Escaping kernels -- the content types with well known escaping
+     *  tables have specialized escaping functions.
+     */
+    enum Kernel_t {
+        KERNEL_TABLE, //!< escaping driven by the escape table
+        KERNEL_HTML,  //!< HTML/XHTML/XML escaping
+        KERNEL_JS,    //!< javascript escaping
+    };
+
     /** @short Create new empty descriptor.
      */
     ContentType_t();
@@ -69,7 +78,7 @@ public:
      */
     int64_t addEscape(unsigned char c, const std::string &escape);
 
-    /** @short Compile unescaping automaton from escaping list.
+    /** @short Compile unescaping table from escaping list.
      */
     void compileUnescaper();
 
@@ -102,6 +111,13 @@ public:
      */
     static const Descriptor_t *find(const string_view_t &name_view);
 
+    /**
+     * @short Find content type descriptor of given content type.
+     * @param contentType content type escaper
+     * @return descriptor or 0 if content type is unknown
+     */
+    static const Descriptor_t *find(const ContentType_t *contentType);
+
     /**
      * @short Get default content type.
      * @return default content type descriptor
@@ -122,6 +138,11 @@ public:
      */
     std::pair<std::string, std::string> blockComment;
 
+    /** @short Kernel used for escaping, it has to implement the same
+     *  escaping as the escaping table.
+     */
+    Kernel_t kernel;
+
 private:
     /**
      * @short List of escape rules.
@@ -134,19 +155,92 @@ private:
     int64_t escapeBitmap[256];
 
     /**
-     * @short Unescaping automaton.
+     * @short Unescaping table -- escape sequences with their unescaped
+     *        characters ordered by the first character of sequence.
      */
-    std::vector<std::pair<int64_t, int64_t>> unescaper;
+    std::vector<std::pair<std::string, char>> unescapes;
 
     /**
-     * @short Moves to next state of automaton.
-     * @param c characted being matched
-     * @param state current state
-     * @return new +state or -character or 0 (on no match)
+     * @short Map of the first character of escape sequence to the index of
+     *        the first matching entry in unescapes (-1 -> no sequence).
      */
-    int64_t nextState(unsigned char c, int64_t state) const;
+    int64_t unescapeBitmap[256];
+
+    /**
+     * @short Returns true if some escape sequence starts with given character.
+     */
+    bool canStartEscape(char ch) const {
+        return unescapeBitmap[static_cast<unsigned char>(ch)] >= 0;
+    }
+};
+
+/** @short Escaping kernel of HTML/XHTML/XML content types.
+ */
+struct HtmlEscaping_t {
+    static constexpr const char *sequence(char ch) {
+        switch (ch) {
+        case '&': return "&amp;";
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        case '"': return "&quot;";
+        default: return nullptr;
+        }
+    }
 };
 
+/** @short Escaping kernel of javascript content type.
+ */
+struct JsEscaping_t {
+    static constexpr const char *sequence(char ch) {
+        switch (ch) {
+        case '\\': return "\\\\";
+        case '\n': return "\\n";
+        case '\r': return "\\r";
+        case '\a': return "\\a";
+        case '\0': return "\\0";
+        case '\v': return "\\v";
+        case '\'': return "\\'";
+        case '"': return "\\\"";
+        case '/': return "\\/";
+        default: return nullptr;
+        }
+    }
+};
+
+/** @short Escaping table of the escaping kernel built in compile time.
+ */
+template <typename Escaping_t>
+struct EscapingTable_t {
+    constexpr EscapingTable_t() {
+        for (auto i = 0; i < 256; ++i) {
+            auto *sequence = Escaping_t::sequence(static_cast<char>(i));
+            sequences[i] = sequence;
+            if (sequence) while (sequence[lengths[i]]) ++lengths[i];
+        }
+    }
+
+    const char *sequences[256] = {};  //!< escape sequences (nullptr -> none)
+    std::size_t lengths[256] = {};    //!< lengths of escape sequences
+};
+
+/** @short Escapes given string by the escaping kernel.
+ *
+ * @param src string to escape
+ * @return escaped string
+ */
+template <typename Escaping_t>
+std::string escape_string(const string_view_t &src) {
+    static constexpr EscapingTable_t<Escaping_t> table;
+    std::string dest;
+    dest.reserve(src.size());
+    for (auto ch: src) {
+        auto i = static_cast<unsigned char>(ch);
+        if (!table.lengths[i]) dest.push_back(ch);
+        else dest.append(table.sequences[i], table.lengths[i]);
+    }
+    return dest;
+}
+
 class Escaper_t {
 public:
     /** @short Creates new escaper with given or default content type.
@@ -185,6 +279,10 @@ public:
      */
     std::size_t size() const {return escapers.size();}
 
+    /** @short Returns the content type on the top of the stack.
+     */
+    const ContentType_t *top() const {return escapers.top();}
+
     /** @short Escape given string.
      *
      * Uses escaper on the top of the stack.
@@ -0,0 +1,186 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng access to nodes of data tree.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGDATANODE_H
+#define TENGDATANODE_H
+
+#include <stdexcept>
+
+#include "teng/value.h"
+#include "teng/fragment.h"
+#include "teng/stringview.h"
+#include "teng/datasource.h"
+#include "teng/fragmentlist.h"
+#include "teng/fragmentvalue.h"
+
+namespace Teng {
+
+/** Internal data source whose fragment nodes are the rows of native columnar
+ * lists (see FragmentList_t(FragmentColumns_t &&)). The node ptr is the
+ * columns and the id is the row index, so the row behaves like any other
+ * fragment.
+ */
+class ColumnarRows_t: public DataSource_t {
+public:
+    /** Returns value referencing the i-th row of columns.
+     */
+    Value_t row(const FragmentColumns_t *columns, std::size_t i) const {
+        return frag(columns, i);
+    }
+
+    /** The rows source has no root.
+     */
+    Value_t root() const override {return Value_t();}
+
+    /** Returns the value of column of desired name in the row.
+     */
+    Value_t
+    attr(const DataNode_t &row, const string_view_t &name) const override {
+        auto *column = columns(row).find(name);
+        return column? cell(*column, row.id): Value_t();
+    }
+
+    /** The rows have no lists.
+     */
+    std::size_t size(const DataNode_t &) const override {return 0;}
+
+    /** The rows have no lists.
+     */
+    Value_t item(const DataNode_t &, std::size_t) const override {
+        return Value_t();
+    }
+
+    /** Calls the visitor for each column of the row.
+     */
+    void
+    visit(const DataNode_t &row, const Visitor_t &visitor) const override {
+        for (auto &column: columns(row))
+            visitor(string_view_t(column.name), cell(column, row.id));
+    }
+
+private:
+    /** Returns the columns of the row.
+     */
+    static const FragmentColumns_t &columns(const DataNode_t &row) {
+        return *static_cast<const FragmentColumns_t *>(row.ptr);
+    }
+
+    /** Returns the value of column in the i-th row.
+     */
+    static Value_t
+    cell(const FragmentColumns_t::Column_t &column, uint64_t i) {
+        using Column_t = FragmentColumns_t::Column_t;
+        switch (column.type) {
+        case Column_t::tag::integral:
+            return Value_t(column.integrals[i]);
+        case Column_t::tag::real:
+            return Value_t(column.reals[i]);
+        case Column_t::tag::string:
+            return Value_t(string_view_t(column.strings[i]));
+        }
+        throw std::runtime_error(__PRETTY_FUNCTION__);
+    }
+};
+
+/** The source of all rows of native columnar lists.
+ */
+inline const ColumnarRows_t columnar_rows;
+
+// The functions below dispatch the access to fragment and list nodes either
+// to the native data tree, that is accessed inline, or to the data source of
+// the node.
+
+/** Returns attribute for desired name, no matter of value it is.
+ */
+inline Value_t get_attr(const Fragment_t *frag, const string_view_t &name) {
+    if (!frag)
+        return Value_t();
+    if (auto *value = frag->get(name))
+        return Value_t(value);
+    return Value_t();
+}
+
+/** Returns attribute of fragment node for desired name.
+ */
+inline Value_t
+get_attr(const Value_t::frag_ref_type &frag, const string_view_t &name) {
+    if (!frag.source)
+        return get_attr(frag.frag(), name);
+    return frag.source->attr(frag, name);
+}
+
+/** Returns the number of items of list node.
+ */
+inline std::size_t list_size(const Value_t::list_ref_type &list) {
+    if (!list.source)
+        return list.list()->size();
+    return list.source->size(list);
+}
+
+/** Returns the i-th item of list node, the index has to be in range.
+ */
+inline Value_t list_item(const Value_t::list_ref_type &list, std::size_t i) {
+    if (list.source)
+        return list.source->item(list, i);
+    if (auto *columns = list.list()->columns())
+        return columnar_rows.row(columns, i);
+    return Value_t(&(*list.list())[i]);
+}
+
+/** Calls the callback for each attribute of fragment node.
+ */
+template <typename Callback_t>
+void for_each_attr(const Value_t::frag_ref_type &frag, Callback_t callback) {
+    if (frag.source)
+        return frag.source->visit(frag, callback);
+    for (auto &item: *frag.frag())
+        callback(string_view_t(item.first), Value_t(&item.second));
+}
+
+/** Returns true if fragment node has no attribute.
+ */
+inline bool frag_empty(const Value_t::frag_ref_type &frag) {
+    if (!frag.source)
+        return frag.frag()->empty();
+    bool empty = true;
+    frag.source->visit(frag, [&] (auto &&, auto &&) {empty = false;});
+    return empty;
+}
+
+} // namespace Teng
+
+#endif /* TENGDATANODE_H */
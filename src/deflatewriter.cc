@@ -0,0 +1,289 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng writer compressing the output by zlib deflate -- implementation.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <zlib.h>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#include "logging.h"
+#include "teng/deflatewriter.h"
+
+namespace Teng {
+namespace {
+
+/** The size of the buffer for the compressed data.
+ */
+constexpr std::size_t buffer_size = 16 * 1024;
+
+/** Initializes raw deflate stream (no zlib header and trailer).
+ */
+int init_raw_deflate(z_stream &zs, int level) {
+    zs.zalloc = nullptr;
+    zs.zfree = nullptr;
+    zs.opaque = nullptr;
+    return deflateInit2(
+        &zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY
+    );
+}
+
+/** Passes data to the deflate stream and calls the sink with each chunk of
+ * the compressed data.
+ */
+template <typename Sink_t>
+int deflate_data(
+    z_stream &zs,
+    const char *str,
+    std::size_t size,
+    int mode,
+    Sink_t &&sink
+) {
+    Bytef buffer[buffer_size];
+    do {
+        // zlib takes at most UINT_MAX bytes at once
+        auto chunk = std::min<std::size_t>(size, UINT_MAX);
+        auto chunk_mode = chunk == size? mode: Z_NO_FLUSH;
+        zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(str));
+        zs.avail_in = static_cast<uInt>(chunk);
+        str += chunk;
+        size -= chunk;
+
+        // compress the chunk
+        do {
+            zs.next_out = buffer;
+            zs.avail_out = buffer_size;
+            if (::deflate(&zs, chunk_mode) == Z_STREAM_ERROR) return -1;
+            auto have = buffer_size - zs.avail_out;
+            if (have && sink(reinterpret_cast<const char *>(buffer), have))
+                return -1;
+        } while (zs.avail_out == 0);
+    } while (size);
+    return 0;
+}
+
+/** Writes 32bit number in little endian.
+ */
+int write_le32(Writer_t &output, uLong value) {
+    char bytes[4];
+    for (auto &byte: bytes) {
+        byte = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+    return output.write(bytes, sizeof(bytes));
+}
+
+} // namespace
+
+/** The cached literal and its compressed form.
+ */
+struct DeflateCache_t::Entry_t {
+    std::string literal;                           //!< the literal (the key)
+    std::shared_ptr<const std::string> compressed; //!< compressed literal
+};
+
+DeflateCache_t::DeflateCache_t(
+    std::size_t minSize,
+    std::size_t maxBytes,
+    int level
+): minSize(minSize), maxBytes(maxBytes), level(level), bytes(0) {}
+
+DeflateCache_t::~DeflateCache_t() = default;
+
+std::shared_ptr<const std::string>
+DeflateCache_t::compress(const char *str, std::size_t size) {
+    // look into the cache first, the full cache does not compress anything
+    {
+        std::lock_guard<std::mutex> locked(mutex);
+        auto ientry = entries.find(std::string_view(str, size));
+        if (ientry != entries.end()) return ientry->second->compressed;
+        if ((bytes + size) > maxBytes) return nullptr;
+    }
+
+    // compress the literal without holding the lock
+    z_stream zs;
+    if (init_raw_deflate(zs, level) != Z_OK) return nullptr;
+    auto compressed = std::make_shared<std::string>();
+    auto res = deflate_data(
+        zs, str, size, Z_FULL_FLUSH,
+        [&] (const char *data, std::size_t len) {
+            compressed->append(data, len);
+            return 0;
+        }
+    );
+    deflateEnd(&zs);
+    if (res) return nullptr;
+
+    // remember the compressed literal if there is still a space for it
+    std::lock_guard<std::mutex> locked(mutex);
+    auto ientry = entries.find(std::string_view(str, size));
+    if (ientry != entries.end()) return ientry->second->compressed;
+    auto entry_bytes = sizeof(Entry_t) + size + compressed->size();
+    if ((bytes + entry_bytes) > maxBytes) return nullptr;
+    bytes += entry_bytes;
+    auto entry = std::make_unique<Entry_t>();
+    entry->literal.assign(str, size);
+    entry->compressed = std::move(compressed);
+    std::string_view key = entry->literal;
+    return entries.emplace(key, std::move(entry)).first->second->compressed;
+}
+
+std::size_t DeflateCache_t::size() const {
+    std::lock_guard<std::mutex> locked(mutex);
+    return entries.size();
+}
+
+/** The zlib stream and the state of the compressed stream.
+ */
+struct DeflateWriter_t::Stream_t {
+    z_stream zs;           //!< zlib stream
+    bool valid = false;    //!< true if the zlib stream has been initialized
+    bool started = false;  //!< true if the header has been written
+    bool finished = false; //!< true if the trailer has been written
+    uLong crc = 0;         //!< crc32 of the uncompressed data
+    uLong size = 0;        //!< size of the uncompressed data (modulo 2^32)
+};
+
+DeflateWriter_t::DeflateWriter_t(
+    Writer_t &output,
+    Format_t format,
+    int level,
+    std::shared_ptr<DeflateCache_t> cache
+): output(output), format(format), cache(std::move(cache)),
+   stream(std::make_unique<Stream_t>())
+{
+    stream->valid = init_raw_deflate(stream->zs, level) == Z_OK;
+    stream->crc = crc32(0, nullptr, 0);
+}
+
+DeflateWriter_t::~DeflateWriter_t() {
+    if (stream->valid) deflateEnd(&stream->zs);
+}
+
+int DeflateWriter_t::start() {
+    if (stream->started) return 0;
+    stream->started = true;
+    if (format != FORMAT_GZIP) return 0;
+
+    // magic, deflate method, no flags, no mtime, no extra flags, unknown os
+    static const char header[] = {
+        '\x1f', '\x8b', '\x08', '\x00',
+        '\x00', '\x00', '\x00', '\x00',
+        '\x00', '\xff'
+    };
+    return output.write(header, sizeof(header));
+}
+
+void DeflateWriter_t::checksum(const char *str, std::size_t size) {
+    if (format != FORMAT_GZIP) return;
+    auto *bytes = reinterpret_cast<const Bytef *>(str);
+    stream->crc = crc32_z(stream->crc, bytes, size);
+    stream->size += size;
+}
+
+int DeflateWriter_t::deflate(const char *str, std::size_t size, int mode) {
+    if (!stream->valid || stream->finished) {
+        if (err) logFatal(*err, "Can't write to finished deflate stream");
+        return -1;
+    }
+    if (start()) return -1;
+
+    // remember the checksum of the uncompressed data for the gzip trailer
+    if (size) checksum(str, size);
+
+    // compress data and pass them to the underlying writer
+    auto res = deflate_data(
+        stream->zs, str, size, mode,
+        [&] (const char *data, std::size_t len) {
+            return output.write(data, len);
+        }
+    );
+    if (res && err) logFatal(*err, "Error compressing the output");
+    return res;
+}
+
+int DeflateWriter_t::write(const std::string &str) {
+    return write(str.data(), str.size());
+}
+
+int DeflateWriter_t::write(const char *str) {
+    return write(str, strlen(str));
+}
+
+int DeflateWriter_t::write(const char *str, std::size_t size) {
+    return deflate(str, size, Z_NO_FLUSH);
+}
+
+int DeflateWriter_t::writeLiteral(const char *str, std::size_t size) {
+    if (!cache || !cache->isCacheable(size))
+        return deflate(str, size, Z_NO_FLUSH);
+
+    // the literal that is not cached is compressed as a part of the stream
+    auto compressed = cache->compress(str, size);
+    if (!compressed) return deflate(str, size, Z_NO_FLUSH);
+
+    // the full flush drops the compression history and aligns the stream
+    // to byte boundary so the compressed literal can be spliced into it
+    if (deflate(nullptr, 0, Z_FULL_FLUSH)) return -1;
+    checksum(str, size);
+    return output.write(compressed->data(), compressed->size());
+}
+
+int DeflateWriter_t::write(const std::string &str, StringSpan_t interval) {
+    auto *data = str.data() + std::distance(str.begin(), interval.first);
+    return write(data, std::distance(interval.first, interval.second));
+}
+
+int DeflateWriter_t::flush() {
+    if (stream->finished) return output.flush();
+    if (deflate(nullptr, 0, Z_SYNC_FLUSH)) return -1;
+    return output.flush();
+}
+
+int DeflateWriter_t::finish() {
+    if (stream->finished) return 0;
+    if (deflate(nullptr, 0, Z_FINISH)) return -1;
+    stream->finished = true;
+
+    // write gzip trailer
+    if (format == FORMAT_GZIP) {
+        if (write_le32(output, stream->crc)) return -1;
+        if (write_le32(output, stream->size & 0xffffffff)) return -1;
+    }
+    return output.flush();
+}
+
+} // namespace Teng
@@ -48,6 +48,7 @@
 #endif /* DEBUG */
 
 #include "aux.h"
+#include "util.h"
 #include "logging.h"
 #include "platform.h"
 #include "dictionary.h"
@@ -584,11 +585,24 @@ void Dictionary_t::parse(const std::string &filename) {
             return new_entry(name, value);
         }
     );
+    memory.store(0, std::memory_order_relaxed);
 #ifdef DEBUG
     std::cerr << "Dictionary or configuration file " << filename << " parsed."
               << std::endl;
 #endif /* DEBUG */
 }
 
+std::size_t Dictionary_t::memoryUsage() const {
+    if (auto size = memory.load(std::memory_order_relaxed)) return size;
+
+    // the tree node holds the entry, three pointers and the color
+    auto node_size = sizeof(Entries_t::value_type) + 4 * sizeof(void *);
+    auto size = sizeof(Dictionary_t) + sources.memoryUsage();
+    for (auto &entry: entries)
+        size += node_size + heap_size(entry.first) + heap_size(entry.second);
+    memory.store(size, std::memory_order_relaxed);
+    return size;
+}
+
 } // namespace Teng
 
@@ -41,6 +41,7 @@
 #define TENGDICTIONARY_H
 
 #include <map>
+#include <atomic>
 #include <iosfwd>
 #include <string>
 #include <cstdint>
@@ -102,6 +103,13 @@ public:
      */
     const SourceList_t &getSources() const {return sources;}
 
+    /**
+     * @short Returns the estimated heap footprint of the dictionary
+     * (entries and source list). It is computed once after the dictionary
+     * has been parsed.
+     */
+    virtual std::size_t memoryUsage() const;
+
     /**
      * @short Check source files for change.
      *
@@ -158,6 +166,7 @@ protected:
     std::shared_ptr<const Teng::FilesystemInterface_t> filesystem;
     bool expandVars;      //!< expand variables in dict values
     bool replaceEntries;  //!< replace already present entries in dict
+    mutable std::atomic<std::size_t> memory{0}; //!< the memory usage
 };
 
 } // namespace Teng
@@ -0,0 +1,106 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng instruction execution counters.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGEXECPROFILER_H
+#define TENGEXECPROFILER_H
+
+#include <vector>
+#include <algorithm>
+
+#include "util.h"
+#include "program.h"
+
+namespace Teng {
+
+/** Counts the executions of each instruction during one render and merges
+ * the counters into the program when the render is done. The time is
+ * measured only for the instructions that can be expensive (see
+ * Program_t::isExecTimed()) to keep the overhead low.
+ */
+class ExecProfiler_t {
+public:
+    /** C'tor.
+     */
+    explicit ExecProfiler_t(const Program_t &program)
+        : program(program), counts(program.size()), times(program.size())
+    {}
+
+    /** Merges the collected counters into the program.
+     */
+    ~ExecProfiler_t() {finish();}
+
+    /** Accounts the instruction at given address that is going to be
+     * executed. The time elapsed since the previous instruction is
+     * attributed to the previous one if it is timed.
+     */
+    void instr(int64_t addr, OPCODE opcode) {
+        if (timed >= 0) stop();
+        ++counts[addr];
+        if (Program_t::isExecTimed(opcode)) {
+            timed = addr;
+            start = Clock_t::now();
+        }
+    }
+
+    /** Merges the collected counters into the program.
+     */
+    void finish() {
+        if (timed >= 0) stop();
+        program.addExecCounters(counts, times);
+        std::fill(counts.begin(), counts.end(), 0);
+        std::fill(times.begin(), times.end(), 0);
+    }
+
+protected:
+    /** Attributes the time elapsed since the start to the timed instruction.
+     */
+    void stop() {
+        times[timed] += elapsed(start);
+        timed = -1;
+    }
+
+    const Program_t &program;     //!< the destination
+    std::vector<uint64_t> counts; //!< the executions of instructions
+    std::vector<uint64_t> times;  //!< the time spent in instructions
+    int64_t timed = -1;           //!< the timed instruction or -1
+    Clock_t::time_point start;    //!< when the timed instruction started
+};
+
+} // namespace Teng
+
+#endif /* TENGEXECPROFILER_H */
+
@@ -251,6 +251,12 @@ int Formatter_t::write(string_view_t str) {
     return 0;
 }
 
+int Formatter_t::writeLiteral(string_view_t str) {
+    if (modeStack.top() == MODE_PASSWHITE)
+        return writer.writeLiteral(str.data(), str.size());
+    return write(str);
+}
+
 int Formatter_t::flush() {
     // flush buffer
     if (!buffer.empty())
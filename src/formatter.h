@@ -77,6 +77,13 @@ public:
      */
     int write(string_view_t str);
 
+    /** @short Write literal of the template to output. The literal is
+     *  passed to the writer as literal only if it is not reformatted.
+     *  @param str literal to be written
+     *  @return 0 OK, !0 error
+     */
+    int writeLiteral(string_view_t str);
+
     /** @short Flushes buffered data.
      *  @return 0 OK, !0 error
      */
@@ -101,9 +101,17 @@ FragmentList_t &
 Fragment_t::addFragmentList(const std::string &name) {
     auto iitem = items.find(name);
     if (iitem != items.end())
-        return iitem->second.ensureFragmentList();
-    auto create_list = TypeTag_t<FragmentList_t>();
-    return items.emplace_hint(iitem, name, create_list)->second.list_value;
+        return iitem->second.ensureFragmentList(resource());
+    FragmentValue_t list(TypeTag_t<FragmentList_t>(), resource());
+    return items.emplace_hint(iitem, name, std::move(list))->second.list_value;
+}
+
+void Fragment_t::addSharedFragment(
+    const std::string &name,
+    std::shared_ptr<const Fragment_t> value
+) {
+    if (!value) throw std::runtime_error(__PRETTY_FUNCTION__);
+    addValue(name, FragmentValue_t(std::move(value)));
 }
 
 void Fragment_t::addValue(const std::string &name, Fragment_t &&value) {
@@ -121,5 +129,13 @@ void Fragment_t::addValue(const std::string &name, FragmentValue_t &&value) {
     else items.emplace_hint(iitem, name, std::move(value));
 }
 
+void Fragment_t::reserve(std::size_t size) {
+#if TENG_FLAT_FRAGMENT
+    items.reserve(size);
+#else /* TENG_FLAT_FRAGMENT */
+    (void)size;
+#endif /* TENG_FLAT_FRAGMENT */
+}
+
 } // namespace Teng
 
@@ -0,0 +1,437 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- binary image of data tree.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <limits>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "util.h"
+#include "teng/fragmentvalue.h"
+#include "teng/fragmentlist.h"
+#include "teng/fragmentimage.h"
+
+namespace Teng {
+namespace {
+
+/** The image file magic.
+ */
+constexpr char image_magic[8] = {'T', 'E', 'N', 'G', 'I', 'M', 'G', 0};
+
+/** The image format version.
+ */
+constexpr uint32_t image_version = 2;
+
+/** Detects images of different endianness.
+ */
+constexpr uint32_t image_byte_order = 0x01020304;
+
+/** The image header.
+ */
+struct Header_t {
+    char magic[8];       //!< the image_magic
+    uint32_t version;    //!< the image_version
+    uint32_t byte_order; //!< the image_byte_order
+    uint64_t nodes;      //!< the number of nodes
+    uint64_t index;      //!< the number of entries of index
+    uint64_t strings;    //!< the size of strings pool
+};
+
+/** The image node. The nodes of nested values follow their parent node, for
+ * fragments the key and value nodes alternate. The fragments refer to their
+ * key nodes sorted by key and lists to their item nodes through the index.
+ */
+struct Node_t {
+    enum class tag: uint8_t {frag, list, string, integral, real};
+    tag type;       //!< the type of node
+    uint8_t pad[7]; //!< unused
+    union {
+        struct {
+            uint32_t offset; //!< offset of string or first index entry
+            uint32_t size;   //!< length of string or number of entries
+        } str;
+        IntType_t integral_value; //!< integral number
+        double real_value;        //!< real number
+    };
+};
+
+static_assert(sizeof(Header_t) == 40, "unexpected header size");
+static_assert(sizeof(Node_t) == 16, "unexpected node size");
+
+/** Builds the image.
+ */
+class ImageWriter_t {
+public:
+    /** Returns the image of data tree.
+     */
+    std::string write(const Fragment_t &root) {
+        write_frag(root);
+        Header_t header{};
+        std::memcpy(header.magic, image_magic, sizeof(image_magic));
+        header.version = image_version;
+        header.byte_order = image_byte_order;
+        header.nodes = nodes.size();
+        header.index = index.size();
+        header.strings = strings.size();
+
+        std::string result;
+        result.reserve(
+            sizeof(header) + nodes.size() * sizeof(Node_t)
+            + index.size() * sizeof(uint32_t) + strings.size()
+        );
+        append(result, &header, sizeof(header));
+        append(result, nodes.data(), nodes.size() * sizeof(Node_t));
+        append(result, index.data(), index.size() * sizeof(uint32_t));
+        result.append(strings);
+        return result;
+    }
+
+private:
+    /** Appends raw bytes to image.
+     */
+    static void append(std::string &result, const void *ptr, std::size_t n) {
+        result.append(static_cast<const char *>(ptr), n);
+    }
+
+    /** Converts size to 32bit offset or throws.
+     */
+    static uint32_t offset(std::size_t value) {
+        if (value > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("The data tree is too large for image");
+        return static_cast<uint32_t>(value);
+    }
+
+    /** Appends new node.
+     */
+    uint32_t push(Node_t::tag type) {
+        auto i = offset(nodes.size());
+        nodes.emplace_back();
+        nodes.back().type = type;
+        return i;
+    }
+
+    /** Appends string node.
+     */
+    uint32_t push_string(uint32_t string_offset, std::size_t size) {
+        auto i = push(Node_t::tag::string);
+        nodes[i].str.offset = string_offset;
+        nodes[i].str.size = offset(size);
+        return i;
+    }
+
+    /** Appends string node, the string is stored to pool.
+     */
+    uint32_t push_string(const std::string &value) {
+        auto string_offset = offset(strings.size());
+        strings.append(value);
+        return push_string(string_offset, value.size());
+    }
+
+    /** Appends key node, the keys are stored to pool only once.
+     */
+    uint32_t push_key(const std::string &key) {
+        auto ikey = key_offsets.find(key);
+        if (ikey != key_offsets.end())
+            return push_string(ikey->second, key.size());
+        auto string_offset = offset(strings.size());
+        key_offsets.emplace(key, string_offset);
+        strings.append(key);
+        return push_string(string_offset, key.size());
+    }
+
+    /** Appends new node with given number of index entries.
+     */
+    uint32_t push_indexed(Node_t::tag type, std::size_t entries) {
+        auto i = push(type);
+        nodes[i].str.offset = offset(index.size());
+        nodes[i].str.size = offset(entries);
+        index.resize(index.size() + entries);
+        return i;
+    }
+
+    /** Appends fragment and its items, the items are sorted by key.
+     */
+    void write_frag(const Fragment_t &frag) {
+        auto i = push_indexed(Node_t::tag::frag, frag.size());
+        auto entry = nodes[i].str.offset;
+        for (auto &item: frag) {
+            index[entry++] = push_key(item.first);
+            write_value(item.second);
+        }
+    }
+
+    /** Appends list of values.
+     */
+    void write_list(const FragmentList_t &list) {
+        auto i = push_indexed(Node_t::tag::list, list.size());
+        auto entry = nodes[i].str.offset;
+        for (auto &item: list) {
+            index[entry++] = offset(nodes.size());
+            write_value(item);
+        }
+    }
+
+    /** Appends any value.
+     */
+    void write_value(const FragmentValue_t &value) {
+        switch (value.type()) {
+        case FragmentValue_t::tag::frag:
+        case FragmentValue_t::tag::frag_ptr:
+            write_frag(*value.fragment());
+            break;
+        case FragmentValue_t::tag::list:
+            // the image stores columnar list as list of fragments
+            if (value.list()->columns())
+                write_list(value.list()->materialized());
+            else write_list(*value.list());
+            break;
+        case FragmentValue_t::tag::string:
+            push_string(*value.string());
+            break;
+        case FragmentValue_t::tag::integral: {
+            auto i = push(Node_t::tag::integral);
+            nodes[i].integral_value = *value.integral();
+            break;
+        }
+        case FragmentValue_t::tag::real: {
+            auto i = push(Node_t::tag::real);
+            nodes[i].real_value = *value.real();
+            break;
+        }
+        }
+    }
+
+    // types
+    using KeyOffsets_t = std::unordered_map<std::string, uint32_t>;
+
+    std::vector<Node_t> nodes;   //!< the nodes
+    std::vector<uint32_t> index; //!< fragment keys and list items
+    std::string strings;         //!< the strings pool
+    KeyOffsets_t key_offsets;    //!< offsets of keys in strings pool
+};
+
+/** Throws the corrupted image error.
+ */
+[[noreturn]] void corrupted(const char *what) {
+    throw std::runtime_error(std::string("Corrupted data tree image: ") + what);
+}
+
+} // namespace
+
+/** The image data.
+ */
+struct FragmentImage_t::Image_t {
+    /** D'tor.
+     */
+    ~Image_t() {if (mapping) munmap(mapping, size);}
+
+    /** Validates the header and sets the section pointers.
+     */
+    void init(const char *ptr, std::size_t len) {
+        data = ptr;
+        size = len;
+        if (size < sizeof(Header_t)) corrupted("too short");
+        std::memcpy(&header, data, sizeof(Header_t));
+        if (std::memcmp(header.magic, image_magic, sizeof(image_magic)))
+            corrupted("bad magic");
+        if (header.version != image_version) corrupted("unsupported version");
+        if (header.byte_order != image_byte_order) corrupted("bad byte order");
+        auto max_nodes = (size - sizeof(Header_t)) / sizeof(Node_t);
+        if (!header.nodes || (header.nodes > max_nodes)) corrupted("bad size");
+        auto rest = size - sizeof(Header_t) - header.nodes * sizeof(Node_t);
+        if (header.index > rest / sizeof(uint32_t)) corrupted("bad size");
+        rest -= header.index * sizeof(uint32_t);
+        if (header.strings != rest) corrupted("bad size");
+        nodes = reinterpret_cast<const Node_t *>(data + sizeof(Header_t));
+        index = reinterpret_cast<const uint32_t *>(nodes + header.nodes);
+        strings = reinterpret_cast<const char *>(index + header.index);
+        if (nodes[0].type != Node_t::tag::frag) corrupted("root is not frag");
+    }
+
+    /** Returns i-th node.
+     */
+    const Node_t &node(uint64_t i) const {
+        if (i >= header.nodes) corrupted("bad node index");
+        return nodes[i];
+    }
+
+    /** Returns the index entries of frag or list node. The entries have to
+     * refer to the following nodes, so the image can't contain cycles.
+     */
+    std::pair<const uint32_t *, const uint32_t *>
+    entries(uint64_t i, Node_t::tag type) const {
+        auto &parent = node(i);
+        if (parent.type != type) corrupted("bad node type");
+        if (uint64_t(parent.str.offset) + parent.str.size > header.index)
+            corrupted("bad index offset");
+        auto *first = index + parent.str.offset;
+        return {first, first + parent.str.size};
+    }
+
+    /** Returns the child node index stored in index entry of i-th node.
+     */
+    uint64_t child(uint64_t i, uint32_t entry) const {
+        if (entry <= i) corrupted("bad node index");
+        return entry;
+    }
+
+    /** Returns string of string node.
+     */
+    string_view_t string(uint64_t i) const {
+        auto &str = node(i);
+        if (str.type != Node_t::tag::string) corrupted("expected string");
+        if (uint64_t(str.str.offset) + str.str.size > header.strings)
+            corrupted("bad string offset");
+        return {strings + str.str.offset, str.str.size};
+    }
+
+    std::string owned;            //!< the image if it is not mapped
+    void *mapping = nullptr;      //!< the mapped image
+    const char *data = nullptr;   //!< the image data
+    std::size_t size = 0;         //!< the image size
+    Header_t header;              //!< copy of the image header
+    const Node_t *nodes;          //!< the nodes section
+    const uint32_t *index;        //!< the index section
+    const char *strings;          //!< the strings section
+};
+
+Value_t FragmentImage_t::value(uint64_t i) const {
+    auto &item = image->node(i);
+    switch (item.type) {
+    case Node_t::tag::frag:
+        return frag(nullptr, i);
+    case Node_t::tag::list:
+        return list(nullptr, i);
+    case Node_t::tag::string:
+        return Value_t(image->string(i));
+    case Node_t::tag::integral:
+        return Value_t(item.integral_value);
+    case Node_t::tag::real:
+        return Value_t(item.real_value);
+    }
+    corrupted("bad node type");
+}
+
+Value_t FragmentImage_t::root() const {
+    return frag(nullptr, 0);
+}
+
+Value_t
+FragmentImage_t::attr(const DataNode_t &frag, const string_view_t &name) const {
+    auto entries = image->entries(frag.id, Node_t::tag::frag);
+    auto *first = entries.first, *last = entries.second;
+    while (first != last) {
+        auto *middle = first + (last - first) / 2;
+        auto key_node = image->child(frag.id, *middle);
+        auto key = image->string(key_node);
+        if (key < name) first = middle + 1;
+        else if (name < key) last = middle;
+        else return value(key_node + 1);
+    }
+    return Value_t();
+}
+
+std::size_t FragmentImage_t::size(const DataNode_t &list) const {
+    auto entries = image->entries(list.id, Node_t::tag::list);
+    return static_cast<std::size_t>(entries.second - entries.first);
+}
+
+Value_t FragmentImage_t::item(const DataNode_t &list, std::size_t i) const {
+    auto entries = image->entries(list.id, Node_t::tag::list);
+    return value(image->child(list.id, entries.first[i]));
+}
+
+void
+FragmentImage_t::visit(const DataNode_t &frag, const Visitor_t &visitor) const {
+    auto entries = image->entries(frag.id, Node_t::tag::frag);
+    for (auto *entry = entries.first; entry != entries.second; ++entry) {
+        auto key_node = image->child(frag.id, *entry);
+        visitor(image->string(key_node), value(key_node + 1));
+    }
+}
+
+std::string makeFragmentImage(const Fragment_t &root) {
+    return ImageWriter_t().write(root);
+}
+
+FragmentImage_t::FragmentImage_t(const std::string &filename) {
+    auto result = std::make_shared<Image_t>();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error(
+            "Cannot open file '" + filename + "': " + strerr(errno)
+        );
+    struct stat buf;
+    if (::fstat(fd, &buf) < 0) {
+        auto error = errno;
+        ::close(fd);
+        throw std::runtime_error(
+            "Cannot stat file '" + filename + "': " + strerr(error)
+        );
+    }
+    auto size = static_cast<std::size_t>(buf.st_size);
+    if (size < sizeof(Header_t)) {
+        ::close(fd);
+        corrupted("too short");
+    }
+    auto *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    auto error = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error(
+            "Cannot map file '" + filename + "': " + strerr(error)
+        );
+    result->mapping = mapping;
+    result->init(static_cast<const char *>(mapping), size);
+    image = std::move(result);
+}
+
+FragmentImage_t FragmentImage_t::fromString(std::string data) {
+    auto image = std::make_shared<Image_t>();
+    image->owned = std::move(data);
+    image->init(image->owned.data(), image->owned.size());
+    return FragmentImage_t(std::move(image));
+}
+
+} // namespace Teng
@@ -36,6 +36,9 @@
  *             Win32 support.
 */
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "jsonutils.h"
 #include "teng/fragmentvalue.h"
 #include "teng/fragmentlist.h"
@@ -43,40 +46,183 @@
 
 namespace Teng {
 
+FragmentList_t::FragmentList_t(FragmentColumns_t &&columns)
+    : table(std::make_unique<Table_t>(std::move(columns)))
+{
+    table->columns.sort();
+}
+
 Fragment_t &FragmentList_t::addFragment() {
-    items.emplace_back(TypeTag_t<Fragment_t>());
+    materialize();
+    items.emplace_back(TypeTag_t<Fragment_t>(), resource());
     return items.back().frag_value;
 }
 
+void
+FragmentList_t::addSharedFragment(std::shared_ptr<const Fragment_t> value) {
+    materialize();
+    if (!value) throw std::runtime_error(__PRETTY_FUNCTION__);
+    items.emplace_back(std::move(value));
+}
+
 FragmentList_t &FragmentList_t::addFragmentList() {
-    items.emplace_back(TypeTag_t<FragmentList_t>());
+    materialize();
+    items.emplace_back(TypeTag_t<FragmentList_t>(), resource());
     return items.back().list_value;
 }
 
 void FragmentList_t::addValue(const std::string &value) {
+    materialize();
     items.emplace_back(value);
 }
 
+void FragmentList_t::addValue(std::string &&value) {
+    materialize();
+    items.emplace_back(std::move(value));
+}
+
 void FragmentList_t::addIntValue(IntType_t value) {
+    materialize();
     items.emplace_back(value);
 }
 
 void FragmentList_t::addRealValue(double value) {
+    materialize();
     items.emplace_back(value);
 }
 
 void FragmentList_t::addValue(Fragment_t &&value) {
+    materialize();
     items.emplace_back(std::move(value));
 }
 
 void FragmentList_t::addValue(FragmentList_t &&value) {
+    materialize();
     items.emplace_back(std::move(value));
 }
 
 void FragmentList_t::addValue(FragmentValue_t &&value) {
+    materialize();
     items.emplace_back(std::move(value));
 }
 
+void FragmentList_t::addFragments(FragmentColumns_t &&columns) {
+    using Column_t = FragmentColumns_t::Column_t;
+
+    // the cells have to be appended in the order of the fragment keys
+    auto &cols = columns.columns;
+    columns.sort();
+
+    materialize();
+    items.reserve(items.size() + columns.rows);
+    for (std::size_t row = 0; row < columns.rows; ++row) {
+        auto &frag = addFragment();
+        frag.reserve(cols.size());
+        for (auto &col: cols) {
+            auto hint = frag.items.end();
+            switch (col.type) {
+            case Column_t::tag::integral:
+                frag.items.emplace_hint(
+                    hint, col.name, FragmentValue_t(col.integrals[row])
+                );
+                break;
+            case Column_t::tag::real:
+                frag.items.emplace_hint(
+                    hint, col.name, FragmentValue_t(col.reals[row])
+                );
+                break;
+            case Column_t::tag::string:
+                frag.items.emplace_hint(
+                    hint, col.name, FragmentValue_t(std::move(col.strings[row]))
+                );
+                break;
+            }
+        }
+    }
+    cols.clear();
+    columns.rows = 0;
+}
+
+FragmentList_t FragmentList_t::materialized() const {
+    FragmentList_t result(resource());
+    if (table) {
+        auto copy = table->columns;
+        result.addFragments(std::move(copy));
+    }
+    return result;
+}
+
+const FragmentList_t::Items_t &FragmentList_t::table_items() const {
+    std::call_once(table->built, [&] {
+        table->items = materialized().items;
+    });
+    return table->items;
+}
+
+void FragmentList_t::materialize_columns() {
+    auto columns = std::move(table->columns);
+    table.reset();
+    addFragments(std::move(columns));
+}
+
+void FragmentColumns_t::sort() {
+    std::sort(columns.begin(), columns.end(), [] (auto &lhs, auto &rhs) {
+        return lhs.name < rhs.name;
+    });
+}
+
+const FragmentColumns_t::Column_t *
+FragmentColumns_t::find(const string_view_t &name) const {
+    for (auto &column: columns)
+        if (string_view_t(column.name) == name)
+            return &column;
+    return nullptr;
+}
+
+FragmentColumns_t::Column_t &
+FragmentColumns_t::append(
+    const std::string &name,
+    Column_t::tag type,
+    std::size_t n
+) {
+    if (!columns.empty() && (n != rows))
+        throw std::runtime_error(
+            "The column '" + name + "' has " + std::to_string(n)
+            + " values but the previous columns have " + std::to_string(rows)
+        );
+    for (auto &col: columns)
+        if (col.name == name)
+            throw std::runtime_error(
+                "The column '" + name + "' has been already added"
+            );
+    rows = n;
+    return columns.emplace_back(name, type);
+}
+
+void FragmentColumns_t::addColumn(
+    const std::string &name,
+    std::vector<IntType_t> values
+) {
+    auto &col = append(name, Column_t::tag::integral, values.size());
+    col.integrals = std::move(values);
+}
+
+void FragmentColumns_t::addColumn(
+    const std::string &name,
+    std::vector<double> values
+) {
+    auto &col = append(name, Column_t::tag::real, values.size());
+    col.reals = std::move(values);
+}
+
+void FragmentColumns_t::addColumn(
+    const std::string &name,
+    std::vector<std::string> values
+) {
+    auto &col = append(name, Column_t::tag::string, values.size());
+    col.strings = std::move(values);
+}
+
 void FragmentList_t::json(std::ostream &o) const {
     o << '[';
     for (auto ifrag = begin(), efrag = end(); ifrag != efrag; ++ifrag) {
@@ -87,7 +233,7 @@ void FragmentList_t::json(std::ostream &o) const {
 }
 
 FragmentList_t::size_type FragmentList_t::size() const {
-    return items.size();
+    return table? table->columns.size(): items.size();
 }
 
 void FragmentList_t::dump(std::ostream &o) const {
@@ -99,11 +245,8 @@ void FragmentList_t::dump(std::ostream &o) const {
     o << ']';
 }
 
-const FragmentValue_t &FragmentList_t::operator[](size_type i) const {
-    return items[i];
-}
-
 FragmentValue_t &FragmentList_t::operator[](size_type i) {
+    materialize();
     return items[i];
 }
 
@@ -50,6 +50,9 @@ namespace {
 template <typename type_t>
 void dispose(type_t *ptr) {ptr->~type_t();}
 
+// shortcut
+using FragPtr_t = std::shared_ptr<const Fragment_t>;
+
 } // namespace
 
 FragmentValue_t::FragmentValue_t(FragmentValue_t &&other) noexcept
@@ -60,7 +63,7 @@ FragmentValue_t::FragmentValue_t(FragmentValue_t &&other) noexcept
         new (&frag_value) Fragment_t(std::move(other.frag_value));
         break;
     case tag::frag_ptr:
-        frag_ptr_value = other.frag_ptr_value;
+        new (&frag_ptr_value) FragPtr_t(std::move(other.frag_ptr_value));
         break;
     case tag::list:
         new (&list_value) FragmentList_t(std::move(other.list_value));
@@ -77,7 +80,7 @@ FragmentValue_t::FragmentValue_t(FragmentValue_t &&other) noexcept
     }
 }
 
-FragmentValue_t &FragmentValue_t::operator=(FragmentValue_t &&other) noexcept {
+FragmentValue_t &FragmentValue_t::operator=(FragmentValue_t &&other) {
     if (&other != this) {
         if (tag_value == other.tag_value) {
             switch (tag_value) {
@@ -85,7 +88,7 @@ FragmentValue_t &FragmentValue_t::operator=(FragmentValue_t &&other) noexcept {
                 frag_value = std::move(other.frag_value);
                 break;
             case tag::frag_ptr:
-                frag_ptr_value = other.frag_ptr_value;
+                frag_ptr_value = std::move(other.frag_ptr_value);
                 break;
             case tag::list:
                 list_value = std::move(other.list_value);
@@ -115,6 +118,7 @@ FragmentValue_t::~FragmentValue_t() noexcept {
         dispose(&frag_value);
         break;
     case tag::frag_ptr:
+        dispose(&frag_ptr_value);
         break;
     case tag::list:
         dispose(&list_value);
@@ -137,7 +141,9 @@ void FragmentValue_t::setValue(const std::string &new_value) {
         tag_value = tag::string;
         break;
     case tag::frag_ptr:
-        throw std::runtime_error(__PRETTY_FUNCTION__);
+        dispose(&frag_ptr_value);
+        new (&string_value) std::string(new_value);
+        tag_value = tag::string;
         break;
     case tag::list:
         dispose(&list_value);
@@ -166,7 +172,9 @@ void FragmentValue_t::setInt(const IntType_t new_value) {
         tag_value = tag::integral;
         break;
     case tag::frag_ptr:
-        throw std::runtime_error(__PRETTY_FUNCTION__);
+        dispose(&frag_ptr_value);
+        integral_value = new_value;
+        tag_value = tag::integral;
         break;
     case tag::list:
         dispose(&list_value);
@@ -196,7 +204,9 @@ void FragmentValue_t::setDouble(double new_value) {
         tag_value = tag::real;
         break;
     case tag::frag_ptr:
-        throw std::runtime_error(__PRETTY_FUNCTION__);
+        dispose(&frag_ptr_value);
+        real_value = new_value;
+        tag_value = tag::real;
         break;
     case tag::list:
         dispose(&list_value);
@@ -286,58 +296,63 @@ void FragmentValue_t::dump(std::ostream &o) const {
     }
 }
 
-FragmentList_t &FragmentValue_t::ensureFragmentList() {
+FragmentList_t &
+FragmentValue_t::ensureFragmentList(FragmentList_t::Resource_t *resource) {
     switch (tag_value) {
     case tag::frag:
         dispose(&frag_value);
-        new (&list_value) FragmentList_t();
+        new (&list_value) FragmentList_t(resource);
         tag_value = tag::list;
         break;
     case tag::frag_ptr:
-        throw std::runtime_error(__PRETTY_FUNCTION__);
+        dispose(&frag_ptr_value);
+        new (&list_value) FragmentList_t(resource);
+        tag_value = tag::list;
         break;
     case tag::list:
         break;
     case tag::string:
         dispose(&string_value);
-        new (&list_value) FragmentList_t();
+        new (&list_value) FragmentList_t(resource);
         tag_value = tag::list;
         break;
     case tag::integral:
-        new (&list_value) FragmentList_t();
+        new (&list_value) FragmentList_t(resource);
         tag_value = tag::list;
         break;
     case tag::real:
-        new (&list_value) FragmentList_t();
+        new (&list_value) FragmentList_t(resource);
         tag_value = tag::list;
         break;
     }
     return list_value;
 }
 
-Fragment_t &FragmentValue_t::ensureFragment() {
+Fragment_t &FragmentValue_t::ensureFragment(Fragment_t::Resource_t *resource) {
     switch (tag_value) {
     case tag::frag:
         break;
     case tag::frag_ptr:
-        throw std::runtime_error(__PRETTY_FUNCTION__);
+        dispose(&frag_ptr_value);
+        new (&frag_value) Fragment_t(resource);
+        tag_value = tag::frag;
         break;
     case tag::list:
-        dispose(&frag_value);
-        new (&frag_value) Fragment_t();
+        dispose(&list_value);
+        new (&frag_value) Fragment_t(resource);
         tag_value = tag::frag;
         break;
     case tag::string:
         dispose(&string_value);
-        new (&frag_value) Fragment_t();
+        new (&frag_value) Fragment_t(resource);
         tag_value = tag::frag;
         break;
     case tag::integral:
-        new (&frag_value) Fragment_t();
+        new (&frag_value) Fragment_t(resource);
         tag_value = tag::frag;
         break;
     case tag::real:
-        new (&frag_value) Fragment_t();
+        new (&frag_value) Fragment_t(resource);
         tag_value = tag::frag;
         break;
     }
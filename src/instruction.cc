@@ -43,6 +43,7 @@
 #include <streambuf>
 #include <unistd.h>
 
+#include "util.h"
 #include "regex.h"
 #include "filestream.h"
 #include "instruction.h"
@@ -332,6 +333,26 @@ static auto eval(OPCODE opcode, type_t &self, call_t &&call, args_t &&...args) {
             self.template as<Print_t>(),
             std::forward<args_t>(args)...
         );
+    case OPCODE::PRINT_RAW:
+        return call(
+            self.template as<PrintRaw_t>(),
+            std::forward<args_t>(args)...
+        );
+    case OPCODE::PRINT_ESC:
+        return call(
+            self.template as<PrintEsc_t>(),
+            std::forward<args_t>(args)...
+        );
+    case OPCODE::PRINT_ESC_HTML:
+        return call(
+            self.template as<PrintEscHtml_t>(),
+            std::forward<args_t>(args)...
+        );
+    case OPCODE::PRINT_ESC_JS:
+        return call(
+            self.template as<PrintEscJs_t>(),
+            std::forward<args_t>(args)...
+        );
     case OPCODE::SET:
         return call(
             self.template as<Set_t>(),
@@ -541,6 +562,10 @@ const char *opcode_str(OPCODE opcode) {
     case OPCODE::PUSH_VAL_INDEX: return "PUSH_VAL_INDEX";
     case OPCODE::PUSH_FRAG: return "PUSH_FRAG";
     case OPCODE::PRINT: return "PRINT";
+    case OPCODE::PRINT_RAW: return "PRINT_RAW";
+    case OPCODE::PRINT_ESC: return "PRINT_ESC";
+    case OPCODE::PRINT_ESC_HTML: return "PRINT_ESC_HTML";
+    case OPCODE::PRINT_ESC_JS: return "PRINT_ESC_JS";
     case OPCODE::AND: return "AND";
     case OPCODE::OR: return "OR";
     case OPCODE::FUNC: return "FUNC";
@@ -764,6 +789,13 @@ void Print_t::dump_params(std::ostream &os) const {
        << '>';
 }
 
+void PrintEsc_t::dump_params(std::ostream &os) const {
+    auto *descriptor = ContentType_t::find(ctype);
+    os << "<mime-type="
+       << (descriptor? descriptor->name: "unknown/unknown")
+       << '>';
+}
+
 void Set_t::dump_params(std::ostream &os) const {
     os << "<name=" << name
        << ",frame-offset=" << frame_offset
@@ -807,6 +839,48 @@ void PushErrorFrag_t::dump_params(std::ostream &os) const {
        << '>';
 }
 
+std::size_t heap_size(const Instruction_t &instr) {
+    switch (instr.opcode()) {
+    case OPCODE::VAL: {
+        auto &value = instr.as<Val_t>().value;
+        if (value.is_string()) return heap_size(value.as_string());
+        if (value.is_regex()) return value.as_regex()->memoryUsage();
+        return 0;
+    }
+    case OPCODE::MATCH_REGEX:
+        return instr.as<MatchRegex_t>().compiled_value->memoryUsage();
+    case OPCODE::VAR:
+        return heap_size(instr.as<Var_t>().name);
+    case OPCODE::SET:
+        return heap_size(instr.as<Set_t>().name);
+    case OPCODE::FUNC:
+        return heap_size(instr.as<Func_t>().name);
+    case OPCODE::OPEN_FRAG:
+        return heap_size(instr.as<OpenFrag_t>().name);
+    case OPCODE::PUSH_FRAG:
+        return heap_size(instr.as<PushFrag_t>().name);
+    case OPCODE::PUSH_ATTR:
+        return heap_size(instr.as<PushAttr_t>().name)
+             + heap_size(instr.as<PushAttr_t>().path);
+    case OPCODE::PUSH_ATTR_AT:
+        return heap_size(instr.as<PushAttrAt_t>().path);
+    case OPCODE::PUSH_VAL_COUNT:
+        return heap_size(instr.as<PushValCount_t>().path);
+    case OPCODE::PUSH_VAL_INDEX:
+        return heap_size(instr.as<PushValIndex_t>().path);
+    case OPCODE::PUSH_VAL_FIRST:
+        return heap_size(instr.as<PushValFirst_t>().path);
+    case OPCODE::PUSH_VAL_LAST:
+        return heap_size(instr.as<PushValLast_t>().path);
+    case OPCODE::PUSH_VAL_INNER:
+        return heap_size(instr.as<PushValInner_t>().path);
+    case OPCODE::CALL:
+        return heap_size(instr.as<Call_t>().name);
+    default:
+        return 0;
+    }
+}
+
 void Call_t::dump_params(std::ostream &os) const {
     os << "<addr=" << addr
        << ",name=" << name
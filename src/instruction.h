@@ -98,7 +98,11 @@ enum class OPCODE {
     CLOSE_CTYPE,     //!< Change content type (pop)
     OPEN_FRAME,      //!< Used to open new frame of fragments
     CLOSE_FRAME,     //!< Uset to close frame of fragements
-    PRINT,           //!< Print onto output
+    PRINT,           //!< Print onto output (escape by runtime content type)
+    PRINT_RAW,       //!< Print onto output without escaping
+    PRINT_ESC,       //!< Print onto output escaped by given content type
+    PRINT_ESC_HTML,  //!< Print onto output escaped by html kernel
+    PRINT_ESC_JS,    //!< Print onto output escaped by javascript kernel
     SET,             //!< Create new variable and assign value
     HALT,            //!< End of program. Relax
     DEBUG_FRAG,      //!< Print data tree (vars & vals) to output
@@ -144,6 +148,21 @@ enum class OPCODE {
  */
 const char *opcode_str(OPCODE opcode);
 
+/** Returns true if opcode is one of the print instructions.
+ */
+inline bool is_print(OPCODE opcode) {
+    switch (opcode) {
+    case OPCODE::PRINT:
+    case OPCODE::PRINT_RAW:
+    case OPCODE::PRINT_ESC:
+    case OPCODE::PRINT_ESC_HTML:
+    case OPCODE::PRINT_ESC_JS:
+        return true;
+    default:
+        return false;
+    }
+}
+
 /** Thrown in debug mode if instruction is casted to invalid type.
  */
 struct bad_instr_cast_t: public std::runtime_error {
@@ -763,18 +782,20 @@ struct Val_t: public Instruction_t {
 struct Var_t: public Instruction_t {
     static constexpr auto instr_opcode = OPCODE::VAR;
     template <typename Variable_t>
-    Var_t(const Variable_t &var, bool escape)
+    Var_t(const Variable_t &var, const std::string *symbol, bool escape)
         : Instruction_t(instr_opcode, var.pos),
           name(var.ident.name().str()),
+          symbol(symbol),
           frame_offset(static_cast<uint16_t>(var.offset.frame)),
           frag_offset(static_cast<uint16_t>(var.offset.frag)),
           escape(escape)
     {}
     void dump_params(std::ostream &os) const;
-    std::string name;      //!< the variable identifier
-    uint16_t frame_offset; //!< the offset of frame (NOT fragment!)
-    uint16_t frag_offset;  //!< the offset of fragment in frame
-    bool escape;           //!< true if variable has to be escaped
+    std::string name;          //!< the variable identifier
+    const std::string *symbol; //!< the name interned by program
+    uint16_t frame_offset;     //!< the offset of frame (NOT fragment!)
+    uint16_t frag_offset;      //!< the offset of fragment in frame
+    bool escape;               //!< true if variable has to be escaped
 };
 
 struct PrgStackAt_t: public Instruction_t {
@@ -887,28 +908,62 @@ struct CloseFrag_t: public Instruction_t {
 
 struct Print_t: public Instruction_t {
     static constexpr auto instr_opcode = OPCODE::PRINT;
-    Print_t(bool print_escape, const Pos_t &pos)
+    Print_t(bool print_escape, const ContentType_t *ctype, const Pos_t &pos)
+        : Instruction_t(instr_opcode, pos),
+          print_escape(print_escape), unoptimizable(false), ctype(ctype)
+    {}
+    void dump_params(std::ostream &os) const;
+    bool print_escape;           //!< do escaping if print escaping is enabled
+    bool unoptimizable;          //!< can't be optimized out
+    const ContentType_t *ctype;  //!< the content type open in compile time
+};
+
+struct PrintRaw_t: public Instruction_t {
+    static constexpr auto instr_opcode = OPCODE::PRINT_RAW;
+    PrintRaw_t(const Pos_t &pos)
+        : Instruction_t(instr_opcode, pos)
+    {}
+};
+
+struct PrintEsc_t: public Instruction_t {
+    static constexpr auto instr_opcode = OPCODE::PRINT_ESC;
+    PrintEsc_t(const ContentType_t *ctype, const Pos_t &pos)
         : Instruction_t(instr_opcode, pos),
-          print_escape(print_escape), unoptimizable(false)
+          ctype(ctype)
     {}
     void dump_params(std::ostream &os) const;
-    bool print_escape;  //!< do escaping if print escaping is enabled
-    bool unoptimizable; //!< can't be optimized out
+    const ContentType_t *ctype; //!< the content type used for escaping
+};
+
+struct PrintEscHtml_t: public Instruction_t {
+    static constexpr auto instr_opcode = OPCODE::PRINT_ESC_HTML;
+    PrintEscHtml_t(const Pos_t &pos)
+        : Instruction_t(instr_opcode, pos)
+    {}
+};
+
+struct PrintEscJs_t: public Instruction_t {
+    static constexpr auto instr_opcode = OPCODE::PRINT_ESC_JS;
+    PrintEscJs_t(const Pos_t &pos)
+        : Instruction_t(instr_opcode, pos)
+    {}
 };
 
 struct Set_t: public Instruction_t {
     static constexpr auto instr_opcode = OPCODE::SET;
     template <typename Variable_t>
-    Set_t(const Variable_t &var)
+    Set_t(const Variable_t &var, const std::string *symbol)
         : Instruction_t(instr_opcode, var.pos),
           name(var.ident.name().str()),
+          symbol(symbol),
           frame_offset(static_cast<uint16_t>(var.offset.frame)),
           frag_offset(static_cast<uint16_t>(var.offset.frag))
     {}
     void dump_params(std::ostream &os) const;
-    std::string name;      //!< the variable identifier
-    uint16_t frame_offset; //!< the offset of frame (NOT fragment!)
-    uint16_t frag_offset;  //!< the offset of fragment in frame
+    std::string name;          //!< the variable identifier
+    const std::string *symbol; //!< the name interned by program
+    uint16_t frame_offset;     //!< the offset of frame (NOT fragment!)
+    uint16_t frag_offset;      //!< the offset of fragment in frame
 };
 
 struct OpenCType_t: public Instruction_t {
@@ -1032,6 +1087,11 @@ protected:
     char padding[p_size]; //!< ensure enough space for the biggest instr
 };
 
+/** Returns the estimated number of bytes the instruction allocates on the
+ * heap (strings and compiled regular expressions).
+ */
+std::size_t heap_size(const Instruction_t &instr);
+
 /** Writes human readable representation of the instruction to ouput stream.
  */
 inline std::ostream &operator<<(std::ostream &os, const Instruction_t &instr) {
@@ -0,0 +1,89 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng render instrumentation (stats and profilers).
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGINSTRUMENTATION_H
+#define TENGINSTRUMENTATION_H
+
+#include <optional>
+
+#include "profiler.h"
+#include "execprofiler.h"
+
+namespace Teng {
+
+/** Bundles all per instruction hooks of one render: the executed
+ * instructions counter, the source level profiler and the execution
+ * counters of the program. The processor calls it only if some of them is
+ * requested, so the uninstrumented render pays a single branch per
+ * instruction.
+ */
+class Instrumentation_t {
+public:
+    /** C'tor.
+     * @param program the rendered program
+     * @param profile collects source level profile if not nullptr
+     */
+    Instrumentation_t(const Program_t &program, Profile_t *profile) {
+        if (profile) profiler.emplace(*profile);
+        if (program.hasExecCounters()) exec_profiler.emplace(program);
+    }
+
+    /** Accounts the instruction at given address that is going to be
+     * executed.
+     */
+    void
+    instr(int64_t addr, const Instruction_t *instr, const OFFApi_t *frames) {
+        ++executed;
+        if (profiler) profiler->instr(instr, frames);
+        if (exec_profiler) exec_profiler->instr(addr, instr->opcode());
+    }
+
+    /** Merges the collected data into the profile and the program.
+     */
+    void finish() {
+        if (profiler) profiler->finish();
+        if (exec_profiler) exec_profiler->finish();
+    }
+
+    uint64_t executed = 0;                        //!< executed instructions
+    std::optional<Profiler_t> profiler;           //!< the source profiler
+    std::optional<ExecProfiler_t> exec_profiler;  //!< the exec counters
+};
+
+} // namespace Teng
+
+#endif /* TENGINSTRUMENTATION_H */
@@ -0,0 +1,470 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- data tree backed by JSON document.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <limits>
+#include <vector>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <stdexcept>
+
+#include "teng/jsondocument.h"
+
+namespace Teng {
+namespace {
+
+/** The maximal nesting of JSON arrays and objects.
+ */
+constexpr uint32_t max_depth = 1024;
+
+/** Node of the JSON document tape. The nodes of nested values follow their
+ * container node, for objects the key and value nodes alternate.
+ */
+struct Node_t {
+    enum class tag: uint8_t {object, array, string, integral, real, null};
+    tag type; //!< the type of node
+    union {
+        struct {
+            uint32_t offset; //!< offset of string in document or of index
+            uint32_t size;   //!< length of string or number of index entries
+        } str;
+        IntType_t integral_value; //!< integral number or boolean
+        double real_value;        //!< real number
+    };
+};
+
+} // namespace
+
+/** The JSON text and its tape.
+ */
+struct JsonDocument_t::Document_t {
+    std::string json;            //!< the text with strings unescaped in place
+    std::vector<Node_t> nodes;   //!< the tape
+    std::vector<uint32_t> index; //!< sorted object keys and array items
+
+    /** Returns the string stored in node.
+     */
+    string_view_t string(uint32_t i) const {
+        return {json.data() + nodes[i].str.offset, nodes[i].str.size};
+    }
+
+    /** Returns the index entries of object or array node.
+     */
+    std::pair<const uint32_t *, const uint32_t *> entries(uint32_t i) const {
+        auto *first = index.data() + nodes[i].str.offset;
+        return {first, first + nodes[i].str.size};
+    }
+};
+
+namespace {
+
+/** Writes UTF-8 representation of the unicode code point to out.
+ */
+char *write_utf8(char *out, uint32_t cp) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xc0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xe0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+    } else {
+        *out++ = static_cast<char>(0xf0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+    }
+    return out;
+}
+
+/** Single pass parser that builds the tape. The escape sequences are decoded
+ * in place, it is safe because decoded sequence is never longer than the
+ * escaped one.
+ */
+class Parser_t {
+public:
+    /** C'tor.
+     */
+    Parser_t(JsonDocument_t::Document_t &doc)
+        : begin(doc.json.data()), pos(begin),
+          end(begin + doc.json.size()), doc(doc)
+    {}
+
+    /** Parses the whole document.
+     */
+    void parse() {
+        skip_ws();
+        if ((pos == end) || (*pos != '{'))
+            error("the root value is not object");
+        parse_value(0);
+        skip_ws();
+        if (pos != end)
+            error("unexpected data after the root value");
+    }
+
+private:
+    /** Throws the parse error.
+     */
+    [[noreturn]] void error(const char *what) const {
+        throw std::runtime_error(
+            "Invalid JSON at offset " + std::to_string(pos - begin)
+            + ": " + what
+        );
+    }
+
+    /** Skips the whitespace characters.
+     */
+    void skip_ws() {
+        while ((pos != end) && (
+            (*pos == ' ') || (*pos == '\n') || (*pos == '\r') || (*pos == '\t')
+        )) ++pos;
+    }
+
+    /** Appends new node to the tape.
+     */
+    uint32_t push(Node_t::tag type) {
+        if (doc.nodes.size() >= std::numeric_limits<uint32_t>::max())
+            error("too many values");
+        doc.nodes.emplace_back();
+        doc.nodes.back().type = type;
+        return static_cast<uint32_t>(doc.nodes.size() - 1);
+    }
+
+    /** Moves the children of container node, collected since mark, from the
+     * stack to the index.
+     */
+    void close(uint32_t i, std::size_t mark) {
+        auto &node = doc.nodes[i];
+        node.str.offset = static_cast<uint32_t>(doc.index.size());
+        node.str.size = static_cast<uint32_t>(children.size() - mark);
+        doc.index.insert(
+            doc.index.end(),
+            children.begin() + mark,
+            children.end()
+        );
+        children.resize(mark);
+    }
+
+    /** Parses any JSON value.
+     */
+    void parse_value(uint32_t depth) {
+        skip_ws();
+        if (pos == end) error("unexpected end of document");
+        switch (*pos) {
+        case '{': return parse_object(depth + 1);
+        case '[': return parse_array(depth + 1);
+        case '"': return parse_string();
+        case 't': return parse_literal("true", Node_t::tag::integral, 1);
+        case 'f': return parse_literal("false", Node_t::tag::integral, 0);
+        case 'n': return parse_literal("null", Node_t::tag::null, 0);
+        default: return parse_number();
+        }
+    }
+
+    /** Parses JSON object. Its keys are sorted in the index.
+     */
+    void parse_object(uint32_t depth) {
+        if (depth > max_depth) error("too deep nesting");
+        auto i = push(Node_t::tag::object);
+        auto mark = children.size();
+        ++pos;
+        skip_ws();
+        if ((pos != end) && (*pos == '}')) {
+            ++pos;
+            return close(i, mark);
+        }
+        for (;;) {
+            skip_ws();
+            if ((pos == end) || (*pos != '"')) error("expected object key");
+            children.push_back(static_cast<uint32_t>(doc.nodes.size()));
+            parse_string();
+            skip_ws();
+            if ((pos == end) || (*pos != ':')) error("expected ':'");
+            ++pos;
+            parse_value(depth);
+            skip_ws();
+            if (pos == end) error("unexpected end of document");
+            if (*pos == '}') {
+                ++pos;
+                break;
+            }
+            if (*pos != ',') error("expected ',' or '}'");
+            ++pos;
+        }
+        // stable sort keeps the first of duplicate keys first
+        std::stable_sort(
+            children.begin() + mark,
+            children.end(),
+            [&] (uint32_t lhs, uint32_t rhs) {
+                return doc.string(lhs) < doc.string(rhs);
+            }
+        );
+        close(i, mark);
+    }
+
+    /** Parses JSON array. Its items are listed in the index.
+     */
+    void parse_array(uint32_t depth) {
+        if (depth > max_depth) error("too deep nesting");
+        auto i = push(Node_t::tag::array);
+        auto mark = children.size();
+        ++pos;
+        skip_ws();
+        if ((pos != end) && (*pos == ']')) {
+            ++pos;
+            return close(i, mark);
+        }
+        for (;;) {
+            skip_ws();
+            children.push_back(static_cast<uint32_t>(doc.nodes.size()));
+            parse_value(depth);
+            skip_ws();
+            if (pos == end) error("unexpected end of document");
+            if (*pos == ']') {
+                ++pos;
+                return close(i, mark);
+            }
+            if (*pos != ',') error("expected ',' or ']'");
+            ++pos;
+        }
+    }
+
+    /** Parses four hex digits of unicode escape sequence.
+     */
+    uint32_t parse_hex4() {
+        if (end - pos < 4) error("invalid unicode escape");
+        uint32_t result = 0;
+        for (auto *stop = pos + 4; pos != stop; ++pos) {
+            result <<= 4;
+            if ((*pos >= '0') && (*pos <= '9')) result |= *pos - '0';
+            else if ((*pos >= 'a') && (*pos <= 'f')) result |= *pos - 'a' + 10;
+            else if ((*pos >= 'A') && (*pos <= 'F')) result |= *pos - 'A' + 10;
+            else error("invalid unicode escape");
+        }
+        return result;
+    }
+
+    /** Parses the unicode escape sequence following "\u". The surrogate pair
+     * is joined, the lone surrogate is replaced by U+FFFD.
+     */
+    uint32_t parse_unicode() {
+        auto cp = parse_hex4();
+        if ((cp < 0xd800) || (cp >= 0xe000)) return cp;
+        if ((cp < 0xdc00) && (end - pos > 1)
+            && (pos[0] == '\\') && (pos[1] == 'u')) {
+            auto *escape = pos;
+            pos += 2;
+            auto low = parse_hex4();
+            if ((low >= 0xdc00) && (low < 0xe000))
+                return 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+            // not a low surrogate, parse it again as standalone sequence
+            pos = escape;
+        }
+        return 0xfffd;
+    }
+
+    /** Parses JSON string. The node refers to the text of the document where
+     * the string is unescaped in place.
+     */
+    void parse_string() {
+        auto i = push(Node_t::tag::string);
+        auto *start = ++pos;
+        auto *out = pos;
+        for (;;) {
+            // jump to the next interesting character
+            auto *chunk = pos;
+            while ((pos != end) && (*pos != '"') && (*pos != '\\')) {
+                if (static_cast<unsigned char>(*pos) < 0x20)
+                    error("control character in string");
+                ++pos;
+            }
+            if (out != chunk) std::memmove(out, chunk, pos - chunk);
+            out += pos - chunk;
+            if (pos == end) error("unterminated string");
+            if (*pos == '"') break;
+            if (++pos == end) error("unterminated string");
+            switch (*pos++) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': out = write_utf8(out, parse_unicode()); break;
+            default:
+                --pos;
+                error("invalid escape sequence");
+            }
+        }
+        if (pos - begin > std::numeric_limits<uint32_t>::max())
+            error("document is too large");
+        doc.nodes[i].str.offset = static_cast<uint32_t>(start - begin);
+        doc.nodes[i].str.size = static_cast<uint32_t>(out - start);
+        ++pos;
+    }
+
+    /** Parses true, false or null.
+     */
+    void parse_literal(const char *literal, Node_t::tag type, IntType_t val) {
+        auto len = std::strlen(literal);
+        if ((std::size_t(end - pos) < len) || std::memcmp(pos, literal, len))
+            error("invalid literal");
+        pos += len;
+        doc.nodes[push(type)].integral_value = val;
+    }
+
+    /** Parses JSON number.
+     */
+    void parse_number() {
+        auto *start = pos;
+        bool integral = true;
+        auto digits = [&] {
+            auto *first = pos;
+            while ((pos != end) && (*pos >= '0') && (*pos <= '9')) ++pos;
+            if (pos == first) error("invalid number");
+        };
+        if (*pos == '-') ++pos;
+        if ((pos != end) && (*pos == '0')) ++pos;
+        else digits();
+        if ((pos != end) && (*pos == '.')) {
+            integral = false;
+            ++pos;
+            digits();
+        }
+        if ((pos != end) && ((*pos == 'e') || (*pos == 'E'))) {
+            integral = false;
+            if ((++pos != end) && ((*pos == '+') || (*pos == '-'))) ++pos;
+            digits();
+        }
+        auto &node = doc.nodes[push(Node_t::tag::integral)];
+        if (integral) {
+            auto res = std::from_chars(start, pos, node.integral_value);
+            if (res.ec == std::errc()) return;
+        }
+        node.type = Node_t::tag::real;
+        std::from_chars(start, pos, node.real_value);
+    }
+
+    char *begin;                     //!< the start of document
+    char *pos;                       //!< the current position
+    char *end;                       //!< the end of document
+    JsonDocument_t::Document_t &doc; //!< the document
+    std::vector<uint32_t> children;  //!< children of open containers
+};
+
+} // namespace
+
+JsonDocument_t::JsonDocument_t(std::string json) {
+    auto document = std::make_shared<Document_t>();
+    document->json = std::move(json);
+    document->nodes.reserve(document->json.size() / 8 + 1);
+    Parser_t(*document).parse();
+    doc = std::move(document);
+}
+
+Value_t JsonDocument_t::value(uint32_t i) const {
+    auto &node = doc->nodes[i];
+    switch (node.type) {
+    case Node_t::tag::object:
+        return frag(nullptr, i);
+    case Node_t::tag::array:
+        return list(nullptr, i);
+    case Node_t::tag::string:
+        return Value_t(doc->string(i));
+    case Node_t::tag::integral:
+        return Value_t(node.integral_value);
+    case Node_t::tag::real:
+        return Value_t(node.real_value);
+    case Node_t::tag::null:
+        return Value_t();
+    }
+    throw std::runtime_error(__PRETTY_FUNCTION__);
+}
+
+Value_t JsonDocument_t::root() const {
+    return frag(nullptr, 0);
+}
+
+Value_t
+JsonDocument_t::attr(const DataNode_t &frag, const string_view_t &name) const {
+    auto entries = doc->entries(static_cast<uint32_t>(frag.id));
+    auto key = std::lower_bound(
+        entries.first,
+        entries.second,
+        name,
+        [&] (uint32_t key, const string_view_t &name) {
+            return doc->string(key) < name;
+        }
+    );
+    if ((key == entries.second) || !(doc->string(*key) == name))
+        return Value_t();
+    return value(*key + 1);
+}
+
+std::size_t JsonDocument_t::size(const DataNode_t &list) const {
+    return doc->nodes[list.id].str.size;
+}
+
+Value_t JsonDocument_t::item(const DataNode_t &list, std::size_t i) const {
+    auto node = doc->entries(static_cast<uint32_t>(list.id)).first[i];
+    if (doc->nodes[node].type == Node_t::tag::null)
+        return Value_t(string_view_t());
+    return value(node);
+}
+
+void
+JsonDocument_t::visit(const DataNode_t &frag, const Visitor_t &visitor) const {
+    auto entries = doc->entries(static_cast<uint32_t>(frag.id));
+    for (auto *key = entries.first; key != entries.second; ++key) {
+        // the duplicate keys are hidden by the first one
+        if (key != entries.first)
+            if (doc->string(key[-1]) == doc->string(*key))
+                continue;
+        if (doc->nodes[*key + 1].type != Node_t::tag::null)
+            visitor(doc->string(*key), value(*key + 1));
+    }
+}
+
+std::size_t JsonDocument_t::size() const {
+    return doc->nodes.size();
+}
+
+} // namespace Teng
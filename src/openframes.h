@@ -40,7 +40,9 @@
 #ifndef TENGOPENFRAMES_H
 #define TENGOPENFRAMES_H
 
+#include <array>
 #include <string>
+#include <vector>
 #include <limits>
 
 #include "teng/error.h"
@@ -49,6 +51,7 @@
 #include "teng/stringview.h"
 #include "teng/fragmentvalue.h"
 #include "openframesapi.h"
+#include "datanode.h"
 
 namespace Teng {
 
@@ -69,24 +72,10 @@ inline uint64_t fix_negative_i(int64_t i, std::size_t max_i) {
     return max_i + i;
 }
 
-/** Returns attribute for desired name, no matter of value it is.
+/** Returns attribute of the open fragment. The open fragment is either
+ * fragment or list item.
  */
-inline Value_t get_attr(const Fragment_t *frag, const string_view_t &name) {
-    if (!frag)
-        return Value_t();
-    auto ivalue = frag->find(name);
-    if (ivalue == frag->end())
-        return Value_t();
-    return Value_t(&ivalue->second);
-}
-
-/** Resolves the 'frag' value:
- *
- * tag::frag_ref - this is returned,
- * tag::list_ref - value built from i-th list item is returned,
- * other - nullptr is return.
- */
-inline const Fragment_t *get_frag(const Value_t &self) {
+inline Value_t get_attr(const Value_t &self, const string_view_t &name) {
     switch (self.type()) {
     case Value_t::tag::undefined:
     case Value_t::tag::integral:
@@ -94,11 +83,18 @@ inline const Fragment_t *get_frag(const Value_t &self) {
     case Value_t::tag::string:
     case Value_t::tag::string_ref:
     case Value_t::tag::regex:
-        return nullptr;
+        return Value_t();
     case Value_t::tag::frag_ref:
-        return self.as_frag_ref().ptr;
-    case Value_t::tag::list_ref:
-        return (*self.as_list_ref().ptr)[self.as_list_ref().i].fragment();
+        return get_attr(self.as_frag_ref(), name);
+    case Value_t::tag::list_ref: {
+        auto &list = self.as_list_ref();
+        if (!list.source && !list.list()->columns())
+            return get_attr((*list.list())[list.i].fragment(), name);
+        auto item = list_item(list, list.i);
+        if (!item.is_frag_ref())
+            return Value_t();
+        return get_attr(item.as_frag_ref(), name);
+    }
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
@@ -121,7 +117,7 @@ inline Value_t get_value_at(const Value_t &self) {
     case Value_t::tag::frag_ref:
         return self;
     case Value_t::tag::list_ref:
-        return Value_t(&(*self.as_list_ref().ptr)[self.as_list_ref().i]);
+        return list_item(self.as_list_ref(), self.as_list_ref().i);
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
@@ -130,14 +126,13 @@ inline Value_t get_value_at(const Value_t &self) {
  *
  * tag::frag_ref - this is returned,
  * tag::list_ref of length one - value built 0-th list list item,
- * tag::list_ref of length other - nullptr is returned,
- * other - nullptr is returned.
+ * tag::list_ref of length other - undefined is returned,
+ * other - undefined is returned.
  *
  * The implicit conversion of one-length-list to frags allows simplyfied dot
  * syntax of runtime variables e.g. "$$a.b.c" instead of e.g. "$$a[0].b[0].c".
  */
-inline const Fragment_t *
-get_lone_frag(const Value_t &self, std::size_t &ambiguous) {
+inline Value_t get_lone_frag(const Value_t &self, std::size_t &ambiguous) {
     switch (self.type()) {
     case Value_t::tag::undefined:
     case Value_t::tag::integral:
@@ -145,14 +140,16 @@ get_lone_frag(const Value_t &self, std::size_t &ambiguous) {
     case Value_t::tag::string:
     case Value_t::tag::string_ref:
     case Value_t::tag::regex:
-        return nullptr;
+        return Value_t();
     case Value_t::tag::frag_ref:
-        return self.as_frag_ref().ptr;
+        return self;
     case Value_t::tag::list_ref:
-        if (self.as_list_ref().ptr->size() == 1)
-            return self.as_list_ref().ptr->begin()->fragment();
-        ambiguous = self.as_list_ref().ptr->size();
-        return nullptr;
+        if (list_size(self.as_list_ref()) == 1) {
+            auto item = list_item(self.as_list_ref(), 0);
+            return item.is_frag_ref()? item: Value_t();
+        }
+        ambiguous = list_size(self.as_list_ref());
+        return Value_t();
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
@@ -170,10 +167,11 @@ inline Value_t get_value_at(const Value_t &self, int64_t i) {
     case Value_t::tag::frag_ref:
         return Value_t();
     case Value_t::tag::list_ref:
-        std::size_t y = fix_negative_i(i, self.as_list_ref().ptr->size());
-        if (y < self.as_list_ref().ptr->size())
-            return Value_t(&(*self.as_list_ref().ptr)[y]);
-        return Value_t();
+        auto size = list_size(self.as_list_ref());
+        std::size_t y = fix_negative_i(i, size);
+        if (y >= size)
+            return Value_t();
+        return list_item(self.as_list_ref(), y);
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
@@ -193,7 +191,7 @@ inline bool move_to_next_list_item(Value_t &self) {
     case Value_t::tag::frag_ref:
         return false;
     case Value_t::tag::list_ref:
-        return ++self.as_list_ref().i < self.as_list_ref().ptr->size();
+        return ++self.as_list_ref().i < list_size(self.as_list_ref());
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
@@ -212,28 +210,167 @@ inline ListPos_t get_list_pos_impl(const Value_t &self) {
     case Value_t::tag::frag_ref:
         return {0, 0, false};
     case Value_t::tag::list_ref:
-        return {self.as_list_ref().i, self.as_list_ref().ptr->size(), true};
+        auto &list = self.as_list_ref();
+        return {list.i, list_size(list), true};
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
 
+/** Local variables of open fragment. The first few variables are stored
+ * inline, so the <?teng set?> directives do not allocate in common case. The
+ * variables are identified by the names interned by program (see
+ * Program_t::intern()).
+ */
+class Locals_t {
+public:
+    /** Returns true if there is no local variable.
+     */
+    bool empty() const {return count == 0;}
+
+    /** Returns local variable of desired name or nullptr. The interned names
+     * are compared by pointers.
+     */
+    const Value_t *find(const std::string *name) const {
+        return find_if(*this, SameName_t{name});
+    }
+
+    /** Returns local variable of desired name or nullptr.
+     */
+    const Value_t *find(const string_view_t &name) const {
+        return find_if(*this, [&] (auto &var) {return *var.name == name;});
+    }
+
+    /** Sets the local variable.
+     */
+    void set(const std::string *name, Value_t &&value) {
+        if (auto *var = find_if(*this, SameName_t{name})) {
+            *var = std::move(value);
+        } else if (count < inlined.size()) {
+            inlined[count++] = {name, std::move(value)};
+        } else {
+            spilled.push_back({name, std::move(value)});
+            ++count;
+        }
+    }
+
+    /** Removes all variables.
+     */
+    void clear() {
+        for (std::size_t i = 0; i < count && i < inlined.size(); ++i)
+            inlined[i].value = Value_t();
+        spilled.clear();
+        count = 0;
+    }
+
+protected:
+    /** The local variable.
+     */
+    struct Local_t {
+        const std::string *name = nullptr; //!< the interned name
+        Value_t value;                     //!< the value of variable
+    };
+
+    /** Predicate that compares interned names by pointers.
+     */
+    struct SameName_t {
+        bool operator()(const Local_t &var) const {return var.name == name;}
+        const std::string *name; //!< the interned name
+    };
+
+    /** Returns the value of the first variable satisfying predicate.
+     */
+    template <typename self_t, typename Pred_t>
+    static auto find_if(self_t &self, Pred_t pred)
+    -> decltype(&self.inlined[0].value) {
+        for (std::size_t i = 0; i < self.count && i < self.inlined.size(); ++i)
+            if (pred(self.inlined[i]))
+                return &self.inlined[i].value;
+        for (auto &var: self.spilled)
+            if (pred(var))
+                return &var.value;
+        return nullptr;
+    }
+
+    std::size_t count = 0;             //!< the number of variables
+    std::array<Local_t, 4> inlined;    //!< the first few variables
+    std::vector<Local_t> spilled;      //!< the other variables
+};
+
+/** Stack that keeps the popped items and reuses them for next pushes, so
+ * neither the items nor their members are allocated again when nested
+ * fragments or frames are opened in loops. The reused item is reinitialized
+ * by its reset() method that accepts the same arguments as its c'tor.
+ */
+template <typename type_t>
+class ReusableStack_t {
+public:
+    /** Pushes new item to the stack.
+     */
+    template <typename... Args_t>
+    type_t &emplace_back(Args_t &&...args) {
+        if (count < items.size())
+            items[count].reset(std::forward<Args_t>(args)...);
+        else items.emplace_back(std::forward<Args_t>(args)...);
+        return items[count++];
+    }
+
+    /** Pops the last item, it is kept for reusing.
+     */
+    void pop_back() {--count;}
+
+    /** Pops all items, they are kept for reusing.
+     */
+    void clear() {count = 0;}
+
+    /** Returns the number of items in stack.
+     */
+    std::size_t size() const {return count;}
+
+    /** Returns the last item.
+     */
+    type_t &back() {return items[count - 1];}
+
+    /** Returns the last item.
+     */
+    const type_t &back() const {return items[count - 1];}
+
+    /** Returns the i-th item.
+     */
+    type_t &operator[](std::size_t i) {return items[i];}
+
+    /** Returns the i-th item.
+     */
+    const type_t &operator[](std::size_t i) const {return items[i];}
+
+protected:
+    std::vector<type_t> items; //!< the items including the popped ones
+    std::size_t count = 0;     //!< the number of items in stack
+};
+
 /** The frame of open frags.
  */
 struct FrameRec_t {
-    FrameRec_t(const FragmentValue_t *root) {
+    FrameRec_t(const Value_t &root) {
+        open_frags.emplace_back(root);
+    }
+
+    /** Reinitializes the reused frame.
+     */
+    void reset(const Value_t &root) {
+        open_frags.clear();
         open_frags.emplace_back(root);
     }
 
     /** Returns true if fragment has been opened.
      */
     bool open_frag(const string_view_t &name) {
-        Value_t new_frag = get_attr(get_frag(open_frags.back().frag), name);
+        Value_t new_frag = get_attr(open_frags.back().frag, name);
         switch (new_frag.type()) {
         case Value_t::tag::frag_ref:
             open_frags.emplace_back(name, std::move(new_frag));
             return true;
         case Value_t::tag::list_ref:
-            if (new_frag.as_list_ref().ptr->empty())
+            if (!list_size(new_frag.as_list_ref()))
                 return false;
             open_frags.emplace_back(name, std::move(new_frag));
             return true;
@@ -295,6 +432,21 @@ struct FrameRec_t {
             result.push_back('.');
     }
 
+    /** Returns the interned name of variable if VarDesc_t contains it.
+     */
+    template <typename VarDesc_t>
+    static auto local_name(const VarDesc_t &var, int)
+    -> decltype(var.symbol) {
+        return var.symbol;
+    }
+
+    /** Fallback for VarDesc_t without interned name.
+     */
+    template <typename VarDesc_t>
+    static string_view_t local_name(const VarDesc_t &var, ...) {
+        return var.name;
+    }
+
     /** Returns the path of the desired variable.
      */
     template <typename VarDesc_t>
@@ -325,11 +477,11 @@ struct FrameRec_t {
 
         // local variables overrides
         auto i = open_frags.size() - var.frag_offset - 1;
-        if (auto *local_var = find_local(i, var.name))
+        if (auto *local_var = find_local(i, local_name(var, 0)))
             return *local_var;
 
         // regular variables
-        return get_attr(get_frag(open_frags[i].frag), var.name);
+        return get_attr(open_frags[i].frag, string_view_t(var.name));
     }
 
     /** Returns the value of the desired variable or an undefined value. The
@@ -346,11 +498,11 @@ struct FrameRec_t {
 
         // local variables overrides
         auto i = open_frags.size() - var_frag_offset - 1;
-        if (auto *local_var = find_local(i, var.name))
+        if (auto *local_var = find_local(i, local_name(var, 0)))
             return *local_var;
 
         // regular variables
-        return get_attr(get_frag(open_frags[i].frag), var.name);
+        return get_attr(open_frags[i].frag, string_view_t(var.name));
     }
 
     /** Get offset of variable identified by path in given list of open frames
@@ -380,25 +532,21 @@ struct FrameRec_t {
 
         // local values can't override fragment values
         auto i = open_frags.size() - var.frag_offset - 1;
-        if (get_attr(get_frag(open_frags[i].frag), var.name))
+        if (get_attr(open_frags[i].frag, string_view_t(var.name)))
             return false;
 
         // insert value
         auto &locals = open_frags[i].locals;
-        auto ilocal_var = locals.find(var.name);
-        if (ilocal_var == locals.end())
-            locals.emplace(var.name, std::move(value));
-        else ilocal_var->second = std::move(value);
+        locals.set(var.symbol, std::move(value));
         return true;
     }
 
     /** Returns local variable of desired name or nullptr.
      */
-    const Value_t *find_local(uint64_t i, const string_view_t &name) const {
-        auto ilocal_var = open_frags[i].locals.find(name);
-        if (ilocal_var == open_frags[i].locals.end())
-            return nullptr;
-        return &ilocal_var->second;
+    template <typename name_t>
+    const Value_t *find_local(uint64_t i, const name_t &name) const {
+        auto &locals = open_frags[i].locals;
+        return locals.empty()? nullptr: locals.find(name);
     }
 
     /** Returns index of desired frag in fragment list.
@@ -450,16 +598,12 @@ struct FrameRec_t {
     }
 
 protected:
-    // storage for local variables
-    struct LocalCmp_t: std::less<string_view_t> {struct is_transparent {};};
-    using Locals_t = std::map<std::string, Value_t, LocalCmp_t>;
-
     /** Record for open fragment.
      */
     struct FragRec_t {
         /** C'tor: for root frag.
          */
-        FragRec_t(const FragmentValue_t *root)
+        FragRec_t(const Value_t &root)
             : frag(root)
         {}
 
@@ -476,6 +620,30 @@ protected:
               error_frag(std::make_unique<FragmentList_t>(std::move(errors)))
         {frag = Value_t(error_frag.get());}
 
+        /** Reinitializes the reused record: for root frag.
+         */
+        void reset(const Value_t &root) {
+            reset(string_view_t(), root);
+        }
+
+        /** Reinitializes the reused record: for regular fragments.
+         */
+        void reset(const string_view_t &new_name, Value_t new_frag) {
+            frag = std::move(new_frag);
+            locals.clear();
+            name = new_name;
+            error_frag.reset();
+        }
+
+        /** Reinitializes the reused record: for error frag.
+         */
+        void reset(FragmentList_t &&errors) {
+            error_frag = std::make_unique<FragmentList_t>(std::move(errors));
+            frag = Value_t(error_frag.get());
+            locals.clear();
+            name = "_error";
+        }
+
         // shortucts
         using FragListPtr_t = std::unique_ptr<FragmentList_t>;
 
@@ -485,7 +653,7 @@ protected:
         FragListPtr_t error_frag; //!< holds frag data from Error_t::getFrags
     };
 
-    std::vector<FragRec_t> open_frags; //!< list of open fragments
+    ReusableStack_t<FragRec_t> open_frags; //!< list of open fragments
 };
 
 /** This class represents runtime stack of open fragments by Teng frag
@@ -521,13 +689,19 @@ public:
 
     /** C'tor.
      */
-    OpenFrames_t(const FragmentValue_t *root)
+    OpenFrames_t(const Value_t &root)
         : root(root)
     {frames.emplace_back(root);}
 
     /** Returns the root fragment.
      */
-    const FragmentValue_t *root_frag() const {return root;}
+    const Value_t &root_frag() const {return root;}
+
+    /** Returns true if the value references the root fragment.
+     */
+    bool is_root(const Value_t &value) const {
+        return value.is_frag_ref() && value == root;
+    }
 
     /** Opens new frame.
      */
@@ -652,7 +826,12 @@ public:
         const Value_t &arg,
         const string_view_t &name,
         std::size_t &ambiguous
-    ) const override {return get_attr(get_lone_frag(arg, ambiguous), name);}
+    ) const override {
+        auto frag = get_lone_frag(arg, ambiguous);
+        if (!frag.is_frag_ref())
+            return Value_t();
+        return get_attr(frag.as_frag_ref(), name);
+    }
 
     /** If the idx argument is numeric and arg is list then idx-th list item is
      * returned. Or if the idx argument is string and arg is convertible to
@@ -710,8 +889,8 @@ public:
     // *********************************************^^^ open fragment frames API
 
 protected:
-    const FragmentValue_t *root;    //!< the fragments tree root
-    std::vector<FrameRec_t> frames; //!< the list of open frames
+    Value_t root;                       //!< the fragments tree root
+    ReusableStack_t<FrameRec_t> frames; //!< the list of open frames
 };
 
 } // namespace Teng
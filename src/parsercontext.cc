@@ -53,6 +53,8 @@
 #include "contenttype.h"
 #include "configuration.h"
 #include "parsercontext.h"
+#include "semanticprint.h"
+#include "tracespan.h"
 
 namespace Teng {
 namespace {
@@ -76,6 +78,31 @@ void compile(Parser::Context_t *ctx) {
             "Unrecoverable syntax error; discarding whole program"
         );
     }
+    // resolve escaping of prints now when the whole program is known
+    auto *report = ctx->report;
+    Parser::CompileTimer_t timer(report? &report->finishTime: nullptr);
+    Parser::specialize_prints(ctx);
+
+    // the program is complete now
+    if (ctx->params->isExecProfileEnabled())
+        ctx->program->enableExecCounters();
+}
+
+/** Stores the compile time to the program and completes the compile
+ * report: the parse time is the rest of the total time since the bison
+ * parser and the semantic actions are interleaved.
+ */
+void finish_program(Parser::Context_t *ctx, uint64_t compileTime) {
+    ctx->program->setCompileTime(compileTime);
+    auto *report = ctx->report;
+    if (!report) return;
+    report->totalTime = compileTime;
+    auto known = report->lex1Time + report->lex2Time + report->evalTime
+               + report->readTime + report->finishTime;
+    report->parseTime = report->totalTime > known
+        ? report->totalTime - known
+        : 0;
+    report->instructions = ctx->program->size();
 }
 
 /** If the last instruction of program is a PRINT then it is marked as
@@ -115,11 +142,16 @@ compile_file(
     const FilesystemInterface_t *filesystem,
     const std::string &filename,
     const std::string &encoding,
-    const std::string &contentType
+    const std::string &contentType,
+    Tracer_t *tracer
 ) {
-    Parser::Context_t ctx(err, dict, params, filesystem, encoding, contentType);
+    Parser::Context_t ctx(
+        err, dict, params, filesystem, encoding, contentType, tracer
+    );
+    auto start = Clock_t::now();
     ctx.load_file(filename, Pos_t(/*base level, no include reference*/));
     compile(&ctx);
+    finish_program(&ctx, elapsed(start));
     return std::move(ctx.program);
 }
 
@@ -131,11 +163,16 @@ compile_string(
     const FilesystemInterface_t *filesystem,
     const std::string &source,
     const std::string &encoding,
-    const std::string &contentType
+    const std::string &contentType,
+    Tracer_t *tracer
 ) {
-    Parser::Context_t ctx(err, dict, params, filesystem, encoding, contentType);
+    Parser::Context_t ctx(
+        err, dict, params, filesystem, encoding, contentType, tracer
+    );
+    auto start = Clock_t::now();
     ctx.load_source(source);
     compile(&ctx);
+    finish_program(&ctx, elapsed(start));
     return std::move(ctx.program);
 }
 
@@ -147,7 +184,8 @@ Context_t::Context_t(
     const Configuration_t *params,
     const FilesystemInterface_t* filesystem,
     const std::string &encoding,
-    const std::string &contentType
+    const std::string &contentType,
+    Tracer_t *tracer
 ): utf8(encoding == "utf-8"),
    program(std::make_unique<Program_t>(err)), dict(dict), params(params),
    filesystem(filesystem), source_codes(), lex1_stack(),
@@ -157,7 +195,13 @@ Context_t::Context_t(
    error_occurred(false), unexpected_token{LEX2::INV, {}, {}},
    expr_start_point{{}, -1, true}, if_start_points(),
    branch_addrs(), case_option_addrs(), optimization_points(),
-   escaper(ContentType_t::find(contentType))
+   escaper(ContentType_t::find(contentType)),
+   report(
+       params->isCompileReportEnabled()
+           ? program->enableCompileReport()
+           : nullptr
+   ),
+   tracer(tracer)
 {}
 
 Context_t::~Context_t() = default;
@@ -169,8 +213,18 @@ void Context_t::load_file(const string_view_t &path, const Pos_t &incl_pos) {
     std::string filename = path.str();
     try {
         // load source code from file
-        source_codes.push_back(flex_string_value_t(filesystem->read(filename)));
+        {
+            TraceSpan_t span(tracer, Tracer_t::LOAD, filename);
+            CompileTimer_t timer(report? &report->readTime: nullptr);
+            source_codes.push_back(
+                flex_string_value_t(filesystem->read(filename))
+            );
+        }
         auto &source_code = source_codes.back();
+        if (report) {
+            ++report->files;
+            report->fileBytes += source_code.size();
+        }
 
         auto *source_path = program->addSource(filesystem, filename).first;
 
@@ -195,6 +249,12 @@ void Context_t::load_source(const std::string &source, const Pos_t *pos) {
     std::copy(source.begin(), source.end(), source_code.data());
     source_codes.push_back(std::move(source_code));
 
+    // the sources with position are parts of already parsed sources
+    if (report && pos) {
+        ++report->reparses;
+        report->reparsedBytes += source.size();
+    }
+
     // create the level 1 lexer for given source code
     pos != nullptr
         ? lex1_stack.emplace(source_codes.back(), utf8, params, *pos)
@@ -211,7 +271,12 @@ Token_t Context_t::next_token() {
     while (!lex1_stack.empty()) {
         // if level 2 lexer is currently in use get next L2 token and process it
         if (lex2().in_use()) {
-            switch (auto token = lex2().next()) {
+            auto token = [&] {
+                CompileTimer_t timer(report? &report->lex2Time: nullptr);
+                return lex2().next();
+            }();
+            if (report) ++report->lex2Tokens;
+            switch (token) {
             default:
                 DBG(std::cerr << "**** " << token << std::endl);
                 return token;
@@ -227,7 +292,12 @@ Token_t Context_t::next_token() {
 
         // get next L1 token and process it
         using LEX1 = Lex1_t::LEX1;
-        switch (auto token = lex1().next()) {
+        auto token = [&] {
+            CompileTimer_t timer(report? &report->lex1Time: nullptr);
+            return lex1().next();
+        }();
+        if (report) ++report->lex1Tokens;
+        switch (token) {
         case LEX1::DICT:
         case LEX1::TENG: case LEX1::TENG_SHORT:
         case LEX1::ESC_EXPR: case LEX1::RAW_EXPR:
@@ -44,6 +44,7 @@
 #include <string>
 #include <memory>
 
+#include "util.h"
 #include "lex1.h"
 #include "lex2.h"
 #include "yystype.h"
@@ -54,6 +55,8 @@
 #include "overriddenblocks.h"
 #include "teng/filesystem.h"
 #include "teng/error.h"
+#include "teng/compilereport.h"
+#include "teng/tracer.h"
 
 namespace Teng {
 
@@ -63,6 +66,7 @@ namespace Teng {
  * @param params Language-independent dictionary (param.conf).
  * @param fs_root Application's root path for teng files.
  * @param filename Template filename (relative to fs_root).
+ * @param tracer Receives the loads of template files (can be nullptr).
  *
  * @return Pointer to program compiled within this context.
  */
@@ -74,7 +78,8 @@ compile_file(
     const FilesystemInterface_t *filesystem,
     const std::string &filename,
     const std::string &encoding,
-    const std::string &contentType
+    const std::string &contentType,
+    Tracer_t *tracer = nullptr
 );
 
 /** Compile string template into a program.
@@ -83,6 +88,7 @@ compile_file(
  * @param params Language-independent dictionary (param.conf).
  * @param fs_root Application's root path for teng files.
  * @param source Whole template is stored in this string.
+ * @param tracer Receives the loads of template files (can be nullptr).
  *
  * @return Pointer to program compiled within this context.
  */
@@ -94,11 +100,32 @@ compile_string(
     const FilesystemInterface_t *filesystem,
     const std::string &source,
     const std::string &encoding,
-    const std::string &contentType
+    const std::string &contentType,
+    Tracer_t *tracer = nullptr
 );
 
 namespace Parser {
 
+/** Adds the time elapsed during its lifetime to the counter of the compile
+ * report. It does nothing if the counter is nullptr.
+ */
+class CompileTimer_t {
+public:
+    /** C'tor.
+     */
+    explicit CompileTimer_t(uint64_t *counter)
+        : counter(counter), start(counter? Clock_t::now(): Clock_t::time_point())
+    {}
+
+    /** D'tor.
+     */
+    ~CompileTimer_t() {if (counter) *counter += elapsed(start);}
+
+private:
+    uint64_t *counter;         //!< the counter or nullptr
+    Clock_t::time_point start; //!< when the timer has been started
+};
+
 /** Parser context contains all necessary parsing-time data.
  */
 struct Context_t {
@@ -110,7 +137,8 @@ struct Context_t {
         const Configuration_t *params,
         const FilesystemInterface_t *filesystem,
         const std::string &encoding,
-        const std::string &contentType
+        const std::string &contentType,
+        Tracer_t *tracer = nullptr
     );
 
     /** D'tor.
@@ -253,6 +281,8 @@ struct Context_t {
     Escaper_t escaper;                   //!< open content types / escaper
     ExtendsBlock_t extends_block;        //!< stack of open 'extends' block
     OverriddenBlocks_t overridden_blocks;//!< used to impl. template inheritance
+    CompileReport_t *report;             //!< the compile report or nullptr
+    Tracer_t *tracer;                    //!< the tracer or nullptr
 };
 
 } // namespace Parser
@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <unistd.h>
+#include <optional>
 
 #include "debug.h"
 #include "instructionpointer.h"
@@ -53,6 +54,7 @@
 #include "processorfrag.h"
 #include "processorops.h"
 #include "processor.h"
+#include "instrumentation.h"
 
 namespace Teng {
 namespace {
@@ -134,6 +136,8 @@ process(Ctx_t *ctx, std::vector<Value_t> &stack, const SubProgram_t &program) {
     GetArg_t get_arg(stack);
     for (InstructionPointer_t ip(program); ip < program.end; ++ip) try {
         ctx->instr = &program[*ip];
+        if (ctx->instrumentation)
+            ctx->instrumentation->instr(*ip, ctx->instr, ctx->frames_ptr);
         DBG(dump_instr(ctx, program, ip, stack, prg_stack, std::cerr));
 
         switch (ctx->instr->opcode()) {
@@ -152,6 +156,27 @@ process(Ctx_t *ctx, std::vector<Value_t> &stack, const SubProgram_t &program) {
             exec::print(ctx, get_arg);
             break;
 
+        case OPCODE::PRINT_RAW:
+            exec::print_raw(
+                ctx, get_arg,
+                *ip > program.start? &program[*ip - 1]: nullptr
+            );
+            break;
+
+        case OPCODE::PRINT_ESC:
+            exec::print(ctx, get_arg, [&] (const string_view_t &v) {
+                return ctx->instr->template as<PrintEsc_t>().ctype->escape(v);
+            });
+            break;
+
+        case OPCODE::PRINT_ESC_HTML:
+            exec::print(ctx, get_arg, escape_string<HtmlEscaping_t>);
+            break;
+
+        case OPCODE::PRINT_ESC_JS:
+            exec::print(ctx, get_arg, escape_string<JsEscaping_t>);
+            break;
+
         case OPCODE::SET:
             exec::set_var(ctx, get_arg);
             break;
@@ -165,7 +190,7 @@ process(Ctx_t *ctx, std::vector<Value_t> &stack, const SubProgram_t &program) {
             break;
 
         case OPCODE::VAR:
-            push(exec::var(ctx, program[ip + 1].opcode() == OPCODE::PRINT));
+            push(exec::var(ctx, is_print(program[ip + 1].opcode())));
             break;
 
         case OPCODE::PRG_STACK_PUSH:
@@ -542,7 +567,12 @@ Processor_t::Processor_t(
    encoding(encoding), contentType(contentType)
 {srand(static_cast<uint32_t>(time(nullptr) ^ getpid()));}
 
-void Processor_t::run(const FragmentValue_t &data, Writer_t &writer) {
+void Processor_t::run(
+    const Value_t &data,
+    Writer_t &writer,
+    Profile_t *profile,
+    bool countInstructions
+) {
     // ensure content type
     auto *desc = ContentType_t::find(contentType);
     if (!desc) {
@@ -560,7 +590,14 @@ void Processor_t::run(const FragmentValue_t &data, Writer_t &writer) {
     stack.reserve(128);
     Formatter_t output(writer);
     RunCtx_t ctx{err, program, dict, params, encoding, ct, data, output};
-    process(&ctx, stack, {0, static_cast<int64_t>(program.size()), program});
+    std::optional<Instrumentation_t> instrumentation;
+    if (countInstructions || profile || program.hasExecCounters()) {
+        instrumentation.emplace(program, profile);
+        ctx.instrumentation = &*instrumentation;
+    }
+    process(&ctx, stack, {0, int64_t(program.size()), program});
+    executed = instrumentation? instrumentation->executed: 0;
+    if (instrumentation) instrumentation->finish();
 
     // log errors into log, if said
     if (params.isLogToOutputEnabled()) logErrors(ct, writer, err);
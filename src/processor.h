@@ -55,10 +55,10 @@ class Value_t;
 class Writer_t;
 struct OFFApi_t;
 class Program_t;
-class FragmentValue_t;
 class Dictionary_t;
 class Configuration_t;
 class ContentType_t;
+class Profile_t;
 
 /** Does the template interpretation.
  */
@@ -84,10 +84,18 @@ public:
 
     /** Execute program.
      *
-     * @param data Application data supplied by user.
+     * @param data Root fragment of application data supplied by user.
      * @param writer Output stream object.
+     * @param profile Collects source level profile if not nullptr.
+     * @param countInstructions Counts the executed instructions if true (see
+     *                          executedInstructions()).
      */
-    void run(const FragmentValue_t &data, Writer_t &writer);
+    void run(
+        const Value_t &data,
+        Writer_t &writer,
+        Profile_t *profile = nullptr,
+        bool countInstructions = false
+    );
 
     /** Try to evaluate an expression.
      *
@@ -95,6 +103,11 @@ public:
      */
     Value_t eval(const OFFApi_t *frames, int64_t start);
 
+    /** Returns the number of instructions executed by the last run or zero
+     * if the run has not counted them.
+     */
+    uint64_t executedInstructions() const {return executed;}
+
 protected:
     Error_t &err;                  //!< error log object
     const Program_t &program;      //!< program (translated template)
@@ -102,6 +115,7 @@ protected:
     const Configuration_t &params; //!< param dictionary
     string_view_t encoding;        //!< the template charset
     string_view_t contentType;     //!< the template content/mime type
+    uint64_t executed = 0;         //!< instructions executed by last run
 };
 
 } // namespace Teng
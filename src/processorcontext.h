@@ -49,6 +49,9 @@
 
 namespace Teng {
 
+// forwards
+class Instrumentation_t;
+
 // types
 namespace exec {using Result_t = Value_t;}
 
@@ -65,6 +68,7 @@ struct EvalCtx_t {
     const Escaper_t *escaper_ptr = nullptr; //!< current string escaping machine
     const Instruction_t *instr = nullptr;   //!< current instruction or nullptr
     uint32_t log_suppressed = 0;            //!< enables errors log
+    Instrumentation_t *instrumentation = nullptr; //!< stats and profilers
 };
 
 /** Processor context variables that depends on runtime data and can't be
@@ -80,10 +84,10 @@ struct RunCtx_t: public EvalCtx_t {
         const Configuration_t &params,
         const string_view_t &encoding,
         const ContentType_t *contentType,
-        const FragmentValue_t &root,
+        const Value_t &root,
         Formatter_t &output
     ): EvalCtx_t{err, program, dict, params, encoding},
-       output(output), frames(&root), escaper(contentType)
+       output(output), frames(root), escaper(contentType)
     {EvalCtx_t::frames_ptr = &frames; EvalCtx_t::escaper_ptr = &escaper;}
 
     /** D'tor.
@@ -54,36 +54,40 @@ namespace {
 
 /** Function that writes fragment value.
  */
-void
-write_frag_val(RunCtx_t *ctx, const FragmentValue_t &val, std::string indent);
+void write_frag_val(RunCtx_t *ctx, const Value_t &val, std::string indent);
 
 /** Function that writes fragment variables.
  */
-bool has_vars_and_frags(const Fragment_t &frag) {
+bool has_vars_and_frags(const Value_t::frag_ref_type &frag) {
     bool vars = false;
     bool frags = false;
-    for (auto &var: frag) {
-        switch (var.second.type()) {
-        case FragmentValue_t::tag::frag:
-        case FragmentValue_t::tag::list:
-        case FragmentValue_t::tag::frag_ptr:
-            if (vars) return true;
+    for_each_attr(frag, [&] (const string_view_t &, const Value_t &value) {
+        switch (value.type()) {
+        case Value_t::tag::frag_ref:
+        case Value_t::tag::list_ref:
             frags = true;
             break;
-        case FragmentValue_t::tag::integral:
-        case FragmentValue_t::tag::real:
-        case FragmentValue_t::tag::string:
-            if (frags) return true;
+        case Value_t::tag::integral:
+        case Value_t::tag::real:
+        case Value_t::tag::string:
+        case Value_t::tag::string_ref:
             vars = true;
             break;
+        case Value_t::tag::undefined:
+        case Value_t::tag::regex:
+            break;
         }
-    }
-    return false;
+    });
+    return vars && frags;
 }
 
 /** Function that writes fragment variables.
  */
-void write_vars(RunCtx_t *ctx, const Fragment_t &frag, std::string indent) {
+void write_vars(
+    RunCtx_t *ctx,
+    const Value_t::frag_ref_type &frag,
+    std::string indent
+) {
     // applies escaping on given string
     auto write_escaped = [&] (const string_view_t &what) {
         ctx->output.write(ctx->escaper.escape(what));
@@ -93,83 +97,93 @@ void write_vars(RunCtx_t *ctx, const Fragment_t &frag, std::string indent) {
     auto max_val_len = ctx->params.getMaxDebugValLength();
 
     // write vars
-    for (auto &var: frag) {
-        switch (var.second.type()) {
-        case FragmentValue_t::tag::frag:
-        case FragmentValue_t::tag::list:
-        case FragmentValue_t::tag::frag_ptr:
+    for_each_attr(frag, [&] (const string_view_t &name, const Value_t &var) {
+        switch (var.type()) {
+        case Value_t::tag::frag_ref:
+        case Value_t::tag::list_ref:
+        case Value_t::tag::undefined:
+        case Value_t::tag::regex:
             // skip frags, they will be written after variables
             break;
-        case FragmentValue_t::tag::integral:
+        case Value_t::tag::integral:
             write_escaped(indent);
-            write_escaped(var.first);
+            write_escaped(name);
             write_escaped(": ");
-            write_escaped(std::to_string(*var.second.integral()));
+            write_escaped(std::to_string(var.as_int()));
             write_escaped("\n");
             break;
-        case FragmentValue_t::tag::real:
+        case Value_t::tag::real:
             write_escaped(indent);
-            write_escaped(var.first);
+            write_escaped(name);
             write_escaped(": ");
-            write_escaped(std::to_string(*var.second.real()));
+            write_escaped(std::to_string(var.as_real()));
             write_escaped("\n");
             break;
-        case FragmentValue_t::tag::string:
+        case Value_t::tag::string:
+        case Value_t::tag::string_ref:
             write_escaped(indent);
-            write_escaped(var.first);
+            write_escaped(name);
             write_escaped(": '");
-            write_escaped(clip(*var.second.string(), max_val_len));
+            write_escaped(clip(var.string().str(), max_val_len));
             write_escaped("'\n");
             break;
         }
-    }
+    });
 }
 
 /** Function that recursively writes nested fragments.
  */
-void write_frags(RunCtx_t *ctx, const Fragment_t &frag, std::string indent) {
+void write_frags(
+    RunCtx_t *ctx,
+    const Value_t::frag_ref_type &frag,
+    std::string indent
+) {
     // applies escaping on given string
     auto write_escaped = [&] (const string_view_t &what) {
         ctx->output.write(ctx->escaper.escape(what));
     };
 
     // write frags
-    for (auto &var: frag) {
-        switch (var.second.type()) {
-        case FragmentValue_t::tag::list:
-            for (auto i = 0u; i < var.second.list()->size(); ++i) {
+    for_each_attr(frag, [&] (const string_view_t &name, const Value_t &var) {
+        switch (var.type()) {
+        case Value_t::tag::list_ref: {
+            auto &list = var.as_list_ref();
+            auto size = list_size(list);
+            for (auto i = 0u; i < size; ++i) {
                 write_escaped(indent);
-                write_escaped(var.first);
+                write_escaped(name);
                 write_escaped("[" + std::to_string(i) + "]:\n");
-                write_frag_val(ctx, (*var.second.list())[i], indent + "    ");
-                if (i != (var.second.list()->size() - 1))
+                write_frag_val(ctx, list_item(list, i), indent + "    ");
+                if (i != (size - 1))
                     write_escaped("\n");
             }
             break;
-        case FragmentValue_t::tag::frag:
-        case FragmentValue_t::tag::frag_ptr:
+        }
+        case Value_t::tag::frag_ref:
             write_escaped(indent);
-            write_escaped(var.first);
+            write_escaped(name);
             write_escaped("[0]:\n");
-            write_vars(ctx, *var.second.fragment(), indent + "    ");
-            if (has_vars_and_frags(*var.second.fragment()))
+            write_vars(ctx, var.as_frag_ref(), indent + "    ");
+            if (has_vars_and_frags(var.as_frag_ref()))
                 write_escaped("\n");
-            write_frags(ctx, *var.second.fragment(), indent + "    ");
+            write_frags(ctx, var.as_frag_ref(), indent + "    ");
             write_escaped("\n");
             break;
-        case FragmentValue_t::tag::integral:
-        case FragmentValue_t::tag::real:
-        case FragmentValue_t::tag::string:
+        case Value_t::tag::integral:
+        case Value_t::tag::real:
+        case Value_t::tag::string:
+        case Value_t::tag::string_ref:
+        case Value_t::tag::undefined:
+        case Value_t::tag::regex:
             // skip scalar values, they have been written before variables
             break;
         }
-    }
+    });
 }
 
 /** Function that writes fragment value.
  */
-void
-write_frag_val(RunCtx_t *ctx, const FragmentValue_t &val, std::string indent) {
+void write_frag_val(RunCtx_t *ctx, const Value_t &val, std::string indent) {
     // applies escaping on given string
     auto write_escaped = [&] (const string_view_t &what) {
         ctx->output.write(ctx->escaper.escape(what));
@@ -180,30 +194,36 @@ write_frag_val(RunCtx_t *ctx, const FragmentValue_t &val, std::string indent) {
 
     // write fragment value
     switch (val.type()) {
-    case FragmentValue_t::tag::list:
-        for (auto i = 0u; i < val.list()->size(); ++i) {
+    case Value_t::tag::list_ref: {
+        auto &list = val.as_list_ref();
+        auto size = list_size(list);
+        for (auto i = 0u; i < size; ++i) {
             write_escaped(indent);
             write_escaped("[" + std::to_string(i) + "]:\n");
-            write_frag_val(ctx, (*val.list())[i], indent + "    ");
-            if (i != (val.list()->size() - 1))
+            write_frag_val(ctx, list_item(list, i), indent + "    ");
+            if (i != (size - 1))
                 write_escaped("\n");
         }
         break;
-    case FragmentValue_t::tag::frag:
-    case FragmentValue_t::tag::frag_ptr:
-        write_vars(&*ctx, *val.fragment(), indent);
-        if (has_vars_and_frags(*val.fragment()))
+    }
+    case Value_t::tag::frag_ref:
+        write_vars(ctx, val.as_frag_ref(), indent);
+        if (has_vars_and_frags(val.as_frag_ref()))
             write_escaped("\n");
-        write_frags(&*ctx, *val.fragment(), indent);
+        write_frags(ctx, val.as_frag_ref(), indent);
+        break;
+    case Value_t::tag::integral:
+        write_escaped(std::to_string(val.as_int()));
         break;
-    case FragmentValue_t::tag::integral:
-        write_escaped(std::to_string(*val.integral()));
+    case Value_t::tag::string:
+    case Value_t::tag::string_ref:
+        write_escaped(clip(val.string().str(), max_val_len));
         break;
-    case FragmentValue_t::tag::string:
-        write_escaped(clip(*val.string(), max_val_len));
+    case Value_t::tag::real:
+        write_escaped(std::to_string(val.as_real()));
         break;
-    case FragmentValue_t::tag::real:
-        write_escaped(std::to_string(*val.real()));
+    case Value_t::tag::undefined:
+    case Value_t::tag::regex:
         break;
     };
 }
@@ -243,7 +263,7 @@ void debug_frag(RunCtxPtr_t ctx) {
 
     // app data
     write_escaped("\nApplication data:\n");
-    write_frag_val(&*ctx, *ctx->frames.root_frag(), "    ");
+    write_frag_val(&*ctx, ctx->frames.root_frag(), "    ");
 }
 
 /** Writes bytecode fragment into template if it is enabled.
@@ -253,10 +273,17 @@ void bytecode_frag(RunCtxPtr_t ctx) {
         return;
 
     std::ostringstream out;
-    for (std::size_t i = 0; i < ctx->program.size(); ++i)
+    for (std::size_t i = 0; i < ctx->program.size(); ++i) {
         out << std::setw(3) << std::setfill('0')
-            << std::noshowpos << i << " " << ctx->program[i]
-            << std::endl;
+            << std::noshowpos << i << " ";
+        if (ctx->program.hasExecCounters()) {
+            ctx->program.dumpExecCounter(out, i);
+            out << " ";
+        }
+        out << ctx->program[i] << std::endl;
+    }
+    if (auto *report = ctx->program.compileReport())
+        out << *report;
     ctx->output.write(ctx->escaper.escape(out.str()));
 }
 
@@ -170,9 +170,9 @@ inline Result_t frag_count(RunCtxPtr_t ctx, GetArg_t get_arg) {
     case Value_t::tag::undefined:
         return Result_t();
     case Value_t::tag::list_ref:
-        return Result_t(arg.as_list_ref().ptr->size());
+        return Result_t(list_size(arg.as_list_ref()));
     case Value_t::tag::frag_ref:
-        if (ctx->frames.root_frag()->fragment() == arg.as_frag_ref().ptr)
+        if (ctx->frames.is_root(arg))
             return Result_t(1); // (backward compatibility)
         [[fallthrough]];
     default:
@@ -206,7 +206,7 @@ inline Result_t frag_index(RunCtxPtr_t ctx, GetArg_t get_arg) {
     case Value_t::tag::undefined:
         return Result_t();
     case Value_t::tag::list_ref:
-        switch (arg.as_list_ref().ptr->size()) {
+        switch (list_size(arg.as_list_ref())) {
         case 1:
             return Result_t(0);
         case 0:
@@ -220,13 +220,13 @@ inline Result_t frag_index(RunCtxPtr_t ctx, GetArg_t get_arg) {
             warn(
                 ctx,
                 "The path '" + instr.path + "' references fragment list of "
-                + std::to_string(arg.as_list_ref().ptr->size()) + " fragments; "
+                + std::to_string(list_size(arg.as_list_ref())) + " fragments; "
                 "_index variable is undefined"
             );
             return Result_t();
         }
     case Value_t::tag::frag_ref:
-        if (ctx->frames.root_frag()->fragment() == arg.as_frag_ref().ptr)
+        if (ctx->frames.is_root(arg))
             return Result_t(0); // (backward compatibility)
         [[fallthrough]];
     default:
@@ -260,7 +260,7 @@ inline Result_t is_first_frag(RunCtxPtr_t ctx, GetArg_t get_arg) {
     case Value_t::tag::undefined:
         return Result_t();
     case Value_t::tag::list_ref:
-        switch (arg.as_list_ref().ptr->size()) {
+        switch (list_size(arg.as_list_ref())) {
         case 1:
             return Result_t(arg.as_list_ref().i == 0);
         case 0:
@@ -274,13 +274,13 @@ inline Result_t is_first_frag(RunCtxPtr_t ctx, GetArg_t get_arg) {
             warn(
                 ctx,
                 "The path '" + instr.path + "' references fragment list of "
-                + std::to_string(arg.as_list_ref().ptr->size()) + " fragments; "
+                + std::to_string(list_size(arg.as_list_ref())) + " fragments; "
                 "_first variable is undefined"
             );
             return Result_t();
         }
     case Value_t::tag::frag_ref:
-        if (ctx->frames.root_frag()->fragment() == arg.as_frag_ref().ptr)
+        if (ctx->frames.is_root(arg))
             return Result_t(1); // (backward compatibility)
         [[fallthrough]];
     default:
@@ -314,11 +314,11 @@ inline Result_t is_last_frag(RunCtxPtr_t ctx, GetArg_t get_arg) {
     case Value_t::tag::undefined:
         return Result_t();
     case Value_t::tag::list_ref:
-        switch (arg.as_list_ref().ptr->size()) {
+        switch (list_size(arg.as_list_ref())) {
         case 1: {
             auto i = arg.as_list_ref().i;
-            auto list_size = arg.as_list_ref().ptr->size();
-            return Result_t((i + 1) == list_size);
+            auto size = list_size(arg.as_list_ref());
+            return Result_t((i + 1) == size);
         }
         case 0:
             warn(
@@ -331,13 +331,13 @@ inline Result_t is_last_frag(RunCtxPtr_t ctx, GetArg_t get_arg) {
             warn(
                 ctx,
                 "The path '" + instr.path + "' references fragment list of "
-                + std::to_string(arg.as_list_ref().ptr->size()) + " fragments; "
+                + std::to_string(list_size(arg.as_list_ref())) + " fragments; "
                 "_last variable is undefined"
             );
             return Result_t();
         }
     case Value_t::tag::frag_ref:
-        if (ctx->frames.root_frag()->fragment() == arg.as_frag_ref().ptr)
+        if (ctx->frames.is_root(arg))
             return Result_t(1); // (backward compatibility)
         [[fallthrough]];
     default:
@@ -371,11 +371,11 @@ inline Result_t is_inner_frag(RunCtxPtr_t ctx, GetArg_t get_arg) {
     case Value_t::tag::undefined:
         return Result_t();
     case Value_t::tag::list_ref:
-        switch (arg.as_list_ref().ptr->size()) {
+        switch (list_size(arg.as_list_ref())) {
         case 1: {
             auto i = arg.as_list_ref().i;
-            auto list_size = arg.as_list_ref().ptr->size();
-            return Result_t((i > 0) && ((i + 1) < list_size));
+            auto size = list_size(arg.as_list_ref());
+            return Result_t((i > 0) && ((i + 1) < size));
         }
         case 0:
             warn(
@@ -388,13 +388,13 @@ inline Result_t is_inner_frag(RunCtxPtr_t ctx, GetArg_t get_arg) {
             warn(
                 ctx,
                 "The path '" + instr.path + "' references fragment list of "
-                + std::to_string(arg.as_list_ref().ptr->size()) + " fragments; "
+                + std::to_string(list_size(arg.as_list_ref())) + " fragments; "
                 "_inner variable is undefined"
             );
             return Result_t();
         }
     case Value_t::tag::frag_ref:
-        if (ctx->frames.root_frag()->fragment() == arg.as_frag_ref().ptr)
+        if (ctx->frames.is_root(arg))
             return Result_t(0); // (backward compatibility)
         [[fallthrough]];
     default:
@@ -590,7 +590,7 @@ inline Result_t push_attr_at(EvalCtx_t *ctx, GetArg_t get_arg) {
                 ctx,
                 "The index '" + index.printable() + "' is out of valid "
                 "range <0, "
-                + std::to_string(arg.as_list_ref().ptr->size())
+                + std::to_string(list_size(arg.as_list_ref()))
                 + ") of the fragments list referenced by this path "
                 "expression '" + instr.path + "'"
             );
@@ -653,7 +653,7 @@ inline Result_t query_count(RunCtxPtr_t ctx, GetArg_t get_arg) {
     auto arg = get_arg();
     switch (arg.type()) {
     case Value_t::tag::frag_ref:
-        if (ctx->frames.root_frag()->fragment() == arg.as_frag_ref().ptr)
+        if (ctx->frames.is_root(arg))
             return Result_t(1); // (backward compatibility)
         [[fallthrough]];
     case Value_t::tag::string:
@@ -670,7 +670,7 @@ inline Result_t query_count(RunCtxPtr_t ctx, GetArg_t get_arg) {
         );
         return Result_t();
     case Value_t::tag::list_ref:
-        return Result_t(arg.as_list_ref().ptr->size());
+        return Result_t(list_size(arg.as_list_ref()));
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
@@ -709,7 +709,7 @@ inline Result_t query_defined(RunCtxPtr_t ctx, GetArg_t get_arg) {
     case Value_t::tag::frag_ref:
         return Result_t(1);
     case Value_t::tag::list_ref:
-        return Result_t(!arg.as_list_ref().ptr->empty());
+        return Result_t(list_size(arg.as_list_ref()) != 0);
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
@@ -742,9 +742,9 @@ inline Result_t query_isempty(RunCtxPtr_t ctx, GetArg_t get_arg) {
         );
         return Result_t();
     case Value_t::tag::frag_ref:
-        return Result_t(arg.as_frag_ref().ptr->empty());
+        return Result_t(frag_empty(arg.as_frag_ref()));
     case Value_t::tag::list_ref:
-        return Result_t(arg.as_list_ref().ptr->empty());
+        return Result_t(list_size(arg.as_list_ref()) == 0);
     }
     throw std::runtime_error(__PRETTY_FUNCTION__);
 }
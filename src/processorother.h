@@ -156,11 +156,11 @@ Result_t func(Ctx_t *ctx, GetArg_t get_arg) {
     return Result_t();
 }
 
-/** Writes string value of top item on stack (arg) to output.
+/** Writes string value of given value to output. The string values are
+ * escaped by given escaping function.
  */
-void print(RunCtxPtr_t ctx, GetArg_t get_arg) {
-    auto arg = get_arg();
-    auto &instr = ctx->instr->as<Print_t>();
+template <typename Escape_t>
+void print_value(RunCtxPtr_t ctx, const Value_t &arg, Escape_t &&escape) {
     arg.print([&] (const string_view_t &v, auto &&tag) {
         switch (Value_t::visited_value(tag)) {
         case Value_t::tag::undefined:
@@ -170,9 +170,7 @@ void print(RunCtxPtr_t ctx, GetArg_t get_arg) {
             break;
         case Value_t::tag::string:
         case Value_t::tag::string_ref:
-            ctx->params.isPrintEscapeEnabled() && instr.print_escape
-                ? ctx->output.write(ctx->escaper.escape(v))
-                : ctx->output.write(v);
+            ctx->output.write(escape(v));
             break;
         case Value_t::tag::regex:
             logWarning(*ctx, "Variable is a regex, not a scalar value");
@@ -190,6 +188,48 @@ void print(RunCtxPtr_t ctx, GetArg_t get_arg) {
     });
 }
 
+/** Writes string value of top item on stack (arg) to output. The string
+ * values are escaped by given escaping function.
+ */
+template <typename Escape_t>
+void print(RunCtxPtr_t ctx, GetArg_t get_arg, Escape_t &&escape) {
+    print_value(ctx, get_arg(), std::forward<Escape_t>(escape));
+}
+
+/** Writes string value of top item on stack (arg) to output unescaped. If
+ * the value is the literal of the preceding VAL instruction it is written
+ * as the template literal.
+ */
+void print_raw(RunCtxPtr_t ctx, GetArg_t get_arg, const Instruction_t *prev) {
+    auto arg = get_arg();
+    if (prev && (prev->opcode() == OPCODE::VAL) && arg.is_string_ref()) {
+        // val() pushes the reference to the literal itself, so the same
+        // data pointer means that the value is the literal
+        auto &literal = prev->as<Val_t>().value;
+        auto &value = arg.as_string_ref();
+        if (literal.is_string()) {
+            auto &str = literal.as_string();
+            if ((value.data() == str.data()) && (value.size() == str.size())) {
+                ctx->output.writeLiteral(value);
+                return;
+            }
+        }
+    }
+    print_value(ctx, arg, [] (const string_view_t &v) {return v;});
+}
+
+/** Writes string value of top item on stack (arg) to output. The string
+ * values are escaped by escaper of the content type open in runtime.
+ */
+void print(RunCtxPtr_t ctx, GetArg_t get_arg) {
+    auto &instr = ctx->instr->as<Print_t>();
+    if (ctx->params.isPrintEscapeEnabled() && instr.print_escape) {
+        print(ctx, get_arg, [&] (const string_view_t &v) {
+            return ctx->escaper.escape(v);
+        });
+    } else print(ctx, get_arg, [] (const string_view_t &v) {return v;});
+}
+
 /** Push new formatter on formatter stack.
  */
 void push_formatter(RunCtxPtr_t ctx) {
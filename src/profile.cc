@@ -0,0 +1,81 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- source level profile of rendered templates.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include "teng/profile.h"
+
+namespace Teng {
+
+void Profile_t::add(
+    const std::string &stack,
+    const std::string &filename,
+    int64_t lineno,
+    uint64_t instructions,
+    uint64_t time
+) {
+    auto &entry = counters[Key_t(stack, filename, lineno)];
+    entry.instructions += instructions;
+    entry.time += time;
+}
+
+std::vector<Profile_t::Entry_t> Profile_t::entries() const {
+    std::vector<Entry_t> result;
+    result.reserve(counters.size());
+    for (auto &counter: counters) {
+        result.emplace_back();
+        auto &entry = result.back();
+        std::tie(entry.stack, entry.filename, entry.lineno) = counter.first;
+        entry.instructions = counter.second.instructions;
+        entry.time = counter.second.time;
+    }
+    return result;
+}
+
+void Profile_t::collapsed(std::ostream &os, Metric_t metric) const {
+    for (auto &counter: counters) {
+        auto value = metric == Metric_t::TIME
+            ? counter.second.time
+            : counter.second.instructions;
+        if (!value) continue;
+        os << std::get<0>(counter.first)
+           << ';' << std::get<1>(counter.first)
+           << ':' << std::get<2>(counter.first)
+           << ' ' << value << '\n';
+    }
+}
+
+} // namespace Teng
+
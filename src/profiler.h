@@ -0,0 +1,210 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- collects source level profile while rendering.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGPROFILER_H
+#define TENGPROFILER_H
+
+#include <map>
+#include <tuple>
+#include <string>
+#include <vector>
+
+#include "util.h"
+#include "instruction.h"
+#include "openframesapi.h"
+#include "teng/profile.h"
+
+namespace Teng {
+
+/** Attributes executed instructions and elapsed time to the template lines
+ * during one render and merges the result into the profile when the render
+ * is done. The stack of open fragments and called blocks is recomputed only
+ * after instructions that can change it.
+ *
+ * The instructions are counted exactly but reading the clock around each
+ * instruction would cost more than most instructions, so the time is
+ * sampled: one of sample_period instructions (in average, the gaps are
+ * random to avoid aliasing with loops) is timed and its time is multiplied
+ * by sample_period.
+ */
+class Profiler_t {
+public:
+    /** The average number of instructions per one timed instruction.
+     */
+    static constexpr uint32_t sample_period = 64;
+
+    /** C'tor.
+     */
+    explicit Profiler_t(Profile_t &profile)
+        : profile(profile)
+    {}
+
+    /** Merges the collected counters into the profile.
+     */
+    ~Profiler_t() {finish();}
+
+    /** Accounts the instruction that is going to be executed. If the
+     * previous instruction has been sampled its time is attributed to it.
+     */
+    void instr(const Instruction_t *instr, const OFFApi_t *frames) {
+        if (sampled) stop_sample();
+
+        // the stack could be changed by the previous instruction
+        if (dirty) refresh(frames);
+
+        // consecutive instructions usually come from the same line
+        Key_t key(stack, instr->pos().filename, instr->pos().lineno);
+        if (!current || key != current_key) {
+            current = &counters[key];
+            current_key = key;
+        }
+        ++current->instructions;
+
+        // time the instruction if it is sampled
+        if (!--until_sample) {
+            until_sample = next_gap();
+            sampled = current;
+            last = Clock_t::now();
+        }
+
+        switch (instr->opcode()) {
+        case OPCODE::CALL:
+            blocks.push_back(&instr->as<Call_t>().name);
+            dirty = true;
+            break;
+        case OPCODE::RETURN:
+            if (!blocks.empty()) blocks.pop_back();
+            dirty = true;
+            break;
+        case OPCODE::OPEN_FRAG:
+        case OPCODE::OPEN_ERROR_FRAG:
+        case OPCODE::CLOSE_FRAG:
+        case OPCODE::OPEN_FRAME:
+        case OPCODE::CLOSE_FRAME:
+            dirty = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    /** Merges the collected counters into the profile.
+     */
+    void finish() {
+        if (sampled) stop_sample();
+        current = nullptr;
+        for (auto &counter: counters) {
+            profile.add(
+                stacks[std::get<0>(counter.first)],
+                *std::get<1>(counter.first),
+                std::get<2>(counter.first),
+                counter.second.instructions,
+                counter.second.time
+            );
+        }
+        counters.clear();
+    }
+
+protected:
+    /** The counters of one template line in one stack.
+     */
+    struct Counters_t {
+        uint64_t instructions = 0; //!< the number of executed instructions
+        uint64_t time = 0;         //!< the elapsed time in nanoseconds
+    };
+
+    // stack index, filename and line
+    using Key_t = std::tuple<std::size_t, const std::string *, int64_t>;
+
+    /** Attributes the scaled time of the sampled instruction to its line.
+     */
+    void stop_sample() {
+        sampled->time += elapsed(last) * sample_period;
+        sampled = nullptr;
+    }
+
+    /** Returns random number of instructions to the next sample, it is
+     * uniformly distributed in [1, 2 * sample_period - 1] (xorshift32).
+     */
+    uint32_t next_gap() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return 1 + seed % (2 * sample_period - 1);
+    }
+
+    /** Builds the stack from the path of open fragments and the called
+     * blocks, e.g. ".a.b" and "body" gives "root;a;b;block body".
+     */
+    void refresh(const OFFApi_t *frames) {
+        std::string name = "root";
+        if (frames) {
+            auto path = frames->current_path();
+            for (auto i = 1u; i < path.size(); ++i) {
+                if (path[i] == '.') continue;
+                if (path[i - 1] == '.') name.push_back(';');
+                name.push_back(path[i]);
+            }
+        }
+        for (auto *block: blocks)
+            name.append(";block ").append(*block);
+
+        auto istack = stack_ids.emplace(name, stacks.size()).first;
+        if (istack->second == stacks.size()) stacks.push_back(name);
+        stack = istack->second;
+        dirty = false;
+    }
+
+    Profile_t &profile;                        //!< the destination
+    std::map<Key_t, Counters_t> counters;      //!< the line counters
+    std::map<std::string, std::size_t> stack_ids; //!< stack to its index
+    std::vector<std::string> stacks;           //!< index to stack
+    std::vector<const std::string *> blocks;   //!< the called blocks
+    std::size_t stack = 0;                     //!< the current stack
+    bool dirty = true;                         //!< stack has to be rebuilt
+    Counters_t *current = nullptr;             //!< the current line
+    Key_t current_key;                         //!< the current line key
+    Counters_t *sampled = nullptr;             //!< line of timed instr
+    Clock_t::time_point last;                  //!< start of timed instr
+    uint32_t seed = 0x9e3779b9;                //!< the gaps generator state
+    uint32_t until_sample = 1;                 //!< instrs to the next sample
+};
+
+} // namespace Teng
+
+#endif /* TENGPROFILER_H */
+
@@ -53,10 +53,59 @@ void Program_t::dump(std::ostream &out) const {
     for (auto &instr: instrs) {
         out << std::setw(3) << std::setfill('0') << std::noshowpos
             << std::distance(instrs.data(), &instr) << '\t';
+        if (hasExecCounters()) {
+            dumpExecCounter(out, std::distance(instrs.data(), &instr));
+            out << '\t';
+        }
         instr.dump(out);
         out << std::endl;
     }
 }
 
+void Program_t::addExecCounters(
+    const std::vector<uint64_t> &counts,
+    const std::vector<uint64_t> &times
+) const {
+    auto size = std::min(counters.size(), counts.size());
+    for (std::size_t i = 0; i < size; ++i) {
+        if (!counts[i]) continue;
+        counters[i].count.fetch_add(counts[i], std::memory_order_relaxed);
+        counters[i].time.fetch_add(times[i], std::memory_order_relaxed);
+    }
+}
+
+void Program_t::resetExecCounters() const {
+    for (auto &counter: counters) {
+        counter.count.store(0, std::memory_order_relaxed);
+        counter.time.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Program_t::dumpExecCounter(std::ostream &out, std::size_t addr) const {
+    auto &counter = counters[addr];
+    auto flags = out.flags();
+    out << '[' << std::noshowpos
+        << counter.count.load(std::memory_order_relaxed) << 'x';
+    if (isExecTimed(instrs[addr].opcode())) {
+        auto time = counter.time.load(std::memory_order_relaxed);
+        out << ' ' << std::fixed << std::setprecision(3)
+            << double(time) / 1e6 << "ms";
+    }
+    out << ']';
+    out.flags(flags);
+}
+
+std::size_t Program_t::memoryUsage() const {
+    if (auto size = memory.load(std::memory_order_relaxed)) return size;
+    auto size = sizeof(Program_t)
+              + instrs.capacity() * sizeof(value_type)
+              + counters.capacity() * sizeof(ExecCounter_t)
+              + sources.memoryUsage();
+    for (auto &instr: instrs) size += heap_size(instr);
+    for (auto &name: names) size += sizeof(name) + heap_size(name);
+    memory.store(size, std::memory_order_relaxed);
+    return size;
+}
+
 } // namespace Teng
 
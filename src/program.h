@@ -40,12 +40,17 @@
 #ifndef TENGPROGRAM_H
 #define TENGPROGRAM_H
 
+#include <set>
 #include <cstdio>
 #include <vector>
+#include <atomic>
+#include <memory>
+#include <string_view>
 
 #include "instruction.h"
 #include "sourcelist.h"
 #include "teng/error.h"
+#include "teng/compilereport.h"
 
 namespace Teng {
 
@@ -54,6 +59,13 @@ namespace Teng {
  */
 class Program_t {
 public:
+    /** The execution counters of one instruction.
+     */
+    struct ExecCounter_t {
+        mutable std::atomic<uint64_t> count{0}; //!< the number of executions
+        mutable std::atomic<uint64_t> time{0};  //!< the time spent in ns
+    };
+
     // types
     using value_type = InstrBox_t;
     using const_iterator = std::vector<value_type>::const_iterator;
@@ -68,7 +80,8 @@ public:
      * @param fp File stream for output. */
     void dump(FILE *fp) const;
 
-    /** Print whole program into stream.
+    /** Print whole program into stream. The instructions are annotated by
+     * the execution counters if they are enabled.
      * @param fp stream for output. */
     void dump(std::ostream &out) const;
 
@@ -172,10 +185,123 @@ public:
      */
     void erase(const_iterator ipos) {instrs.erase(ipos);}
 
+    /** Returns the instance of given variable name shared by all
+     * instructions of the program, so the names can be compared by pointers
+     * in runtime. The names are interned while the program is compiled,
+     * never while it is executed.
+     */
+    const std::string *intern(const string_view_t &name) {
+        auto iname = names.find(std::string_view(name.data(), name.size()));
+        if (iname == names.end()) iname = names.emplace(name.str()).first;
+        return &*iname;
+    }
+
+    /** Returns the estimated size of the page generated by this program or
+     * zero if no page has been generated yet.
+     */
+    std::size_t estimatedOutputSize() const {
+        return outputSize.load(std::memory_order_relaxed);
+    }
+
+    /** Updates the estimated size of the page generated by this program. The
+     * estimate is the exponentially weighted moving average of the page
+     * sizes (alpha = 1/4). The concurrent updates may lose one of the
+     * samples what does not matter for an estimate.
+     */
+    void updateOutputSize(std::size_t size) const {
+        auto prev = outputSize.load(std::memory_order_relaxed);
+        auto next = prev? prev - prev / 4 + size / 4: size;
+        outputSize.store(next, std::memory_order_relaxed);
+    }
+
+    /** Returns the time the compilation of the program took in nanoseconds.
+     * It is the only source of the compile time for the cache stats, the
+     * render stats and the compile report.
+     */
+    uint64_t compileTime() const {return compileNanos;}
+
+    /** Sets the time the compilation of the program took in nanoseconds.
+     */
+    void setCompileTime(uint64_t time) {compileNanos = time;}
+
+    /** Returns the compile report or nullptr if it hasn't been collected.
+     */
+    const CompileReport_t *compileReport() const {return report.get();}
+
+    /** Turns on collecting of the compile report and returns it.
+     */
+    CompileReport_t *enableCompileReport() {
+        if (!report) report = std::make_unique<CompileReport_t>();
+        return report.get();
+    }
+
+    /** Turns on counting of executions of the program instructions. It must
+     * be called after the program is completely compiled.
+     */
+    void enableExecCounters() {
+        counters = std::vector<ExecCounter_t>(instrs.size());
+    }
+
+    /** Returns true if the time spent in the instruction of given opcode
+     * is measured when the executions are counted.
+     */
+    static bool isExecTimed(OPCODE opcode) {
+        switch (opcode) {
+        case OPCODE::FUNC:
+        case OPCODE::MATCH_REGEX:
+        case OPCODE::VAR:
+            return true;
+        default:
+            return is_print(opcode);
+        }
+    }
+
+    /** Returns true if executions of the instructions are counted.
+     */
+    bool hasExecCounters() const {return !counters.empty();}
+
+    /** Returns the execution counters of the instruction at given address.
+     */
+    const ExecCounter_t &execCounter(std::size_t addr) const {
+        return counters[addr];
+    }
+
+    /** Adds the executions and the times collected during one render to the
+     * counters. The counters are shared by all renders of the program.
+     */
+    void addExecCounters(
+        const std::vector<uint64_t> &counts,
+        const std::vector<uint64_t> &times
+    ) const;
+
+    /** Zeroes the execution counters.
+     */
+    void resetExecCounters() const;
+
+    /** Writes the execution counters of the instruction at given address
+     * to the stream, e.g. "[12x 0.034ms]". The time is measured only for
+     * the FUNC, MATCH_REGEX, PRINT and VAR instructions, e.g. "[12x]" is
+     * written for the others.
+     */
+    void dumpExecCounter(std::ostream &out, std::size_t addr) const;
+
+    /** Returns the estimated heap footprint of the program (instructions,
+     * their strings and compiled regexes and the source list). It is
+     * computed once, so the program must not be changed after the first
+     * call.
+     */
+    std::size_t memoryUsage() const;
+
 protected:
     SourceList_t sources;           //!< all source files for this program
     Error_t &error;                 //!< error logger
     std::vector<value_type> instrs; //!< list of program instructions
+    std::set<std::string, std::less<>> names; //!< the interned var names
+    mutable std::atomic<std::size_t> outputSize{0}; //!< estimated page size
+    mutable std::atomic<std::size_t> memory{0};     //!< the memory usage
+    uint64_t compileNanos = 0;                      //!< the compile time
+    std::unique_ptr<CompileReport_t> report;        //!< the compile report
+    std::vector<ExecCounter_t> counters; //!< the execution counters or empty
 };
 
 } // namespace Teng
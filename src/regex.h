@@ -426,6 +426,14 @@ public:
      */
     const regex_flags_t flags() const {return flags_value;}
 
+    /** Returns the estimated heap footprint of the compiled expression.
+     */
+    std::size_t memoryUsage() const {
+        std::size_t code_size = 0;
+        pcre2_pattern_info(code.get(), PCRE2_INFO_SIZE, &code_size);
+        return sizeof(Regex_t) + pattern_string.capacity() + code_size;
+    }
+
     /** Returns first match.
      */
     RegexMatch_t match(string_view_t subject) const {
@@ -101,8 +101,14 @@ void optimize_expr(Context_t *ctx, uint32_t arity, bool lazy_evaluated) {
     // if the args are not optimizable, the expression itself is not optimizable
     if (optimizable) {
         // try to evaluate given part of program
-        Value_t result = ctx->coproc.eval(&ctx->open_frames, args_point);
+        auto *report = ctx->report;
+        Value_t result = [&] {
+            CompileTimer_t timer(report? &report->evalTime: nullptr);
+            return ctx->coproc.eval(&ctx->open_frames, args_point);
+        }();
+        if (report) ++report->evalAttempts;
         if (!result.is_undefined()) {
+            if (report) ++report->evalSuccesses;
             // remove expression's program and replace it with its value
             DBG(std::cerr << "$$$$ optimized => " << result << std::endl);
             auto pos = (*ctx->program)[args_point].pos();
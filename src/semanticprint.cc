@@ -81,33 +81,105 @@ bool are_instrs_protected(Context_t *ctx, int64_t from_addr) {
     return false;
 }
 
+/** If the printed value is a string literal then it is escaped here, in
+ * compile time, by the escaper of the currently open content type. The
+ * returned print escape flag tells the PRINT instruction whether the value
+ * still has to be escaped in runtime.
+ */
+bool escape_literal(Context_t *ctx, bool print_escape) {
+    // nothing to escape
+    if (!print_escape || !ctx->params->isPrintEscapeEnabled())
+        return print_escape;
+
+    // the printed value has to be literal
+    if (ctx->program->empty())
+        return print_escape;
+    if (ctx->program->back().opcode() != OPCODE::VAL)
+        return print_escape;
+
+    // only strings are escaped in runtime
+    auto &value = ctx->program->back().as<Val_t>().value;
+    if (!value.is_string_like())
+        return print_escape;
+
+    // VAL instruction stays at its address so jumps remain valid
+    DBG(std::cerr << "$$$$ print literal escaped" << std::endl);
+    value = Value_t(ctx->escaper.escape(value.string()));
+    return false;
+}
+
+/** Generates print instruction that remembers the content type open in
+ * compile time.
+ */
+void generate_print_instr(Context_t *ctx, bool print_escape) {
+    generate<Print_t>(ctx, print_escape, ctx->escaper.top(), ctx->pos());
+}
+
+/** Replaces the print instruction with the one specialized for its content
+ * type and escaping.
+ */
+void specialize_print(Context_t *ctx, InstrBox_t &instr) {
+    auto &print = instr.as<Print_t>();
+    auto pos = print.pos();
+    auto *ctype = print.ctype;
+
+    // no escaping at all
+    if (!print.print_escape || !ctx->params->isPrintEscapeEnabled()) {
+        instr = InstrBox_t(InstrType_t<PrintRaw_t>(), pos);
+        return;
+    }
+
+    // use escaping kernel of content type if any
+    if (!ctype) return;
+    switch (ctype->kernel) {
+    case ContentType_t::KERNEL_HTML:
+        instr = InstrBox_t(InstrType_t<PrintEscHtml_t>(), pos);
+        break;
+    case ContentType_t::KERNEL_JS:
+        instr = InstrBox_t(InstrType_t<PrintEscJs_t>(), pos);
+        break;
+    case ContentType_t::KERNEL_TABLE:
+        instr = InstrBox_t(InstrType_t<PrintEsc_t>(), ctype, pos);
+        break;
+    }
+}
+
 } // namespace
 
+void specialize_prints(Context_t *ctx) {
+    for (auto &instr: *ctx->program)
+        if (instr.opcode() == OPCODE::PRINT)
+            specialize_print(ctx, instr);
+}
+
 void generate_print(Context_t *ctx, bool print_escape) {
+    // escape literals now rather than in each run
+    print_escape = escape_literal(ctx, print_escape);
+
     // get current program size
     int64_t prgsize = ctx->program->size();
 
     // underflow protect -> no optimalization can be peformed for now
     if (prgsize < 3)
-        return generate<Print_t>(ctx, print_escape, ctx->pos());
+        return generate_print_instr(ctx, print_escape);
 
     // check whether there is no references to vanishing code
     if (are_instrs_protected(ctx, prgsize - 3))
-        return generate<Print_t>(ctx, print_escape, ctx->pos());
+        return generate_print_instr(ctx, print_escape);
 
     // attempt to optimize consecutive print instrs to one merged
     if ((*ctx->program)[prgsize - 1].opcode() != OPCODE::VAL)
-        return generate<Print_t>(ctx, print_escape, ctx->pos());
+        return generate_print_instr(ctx, print_escape);
     if ((*ctx->program)[prgsize - 2].opcode() != OPCODE::PRINT)
-        return generate<Print_t>(ctx, print_escape, ctx->pos());
+        return generate_print_instr(ctx, print_escape);
     if ((*ctx->program)[prgsize - 3].opcode() != OPCODE::VAL)
-        return generate<Print_t>(ctx, print_escape, ctx->pos());
+        return generate_print_instr(ctx, print_escape);
 
     // TODO(burlog): can this replace are_instrs_protected and NOOP insertions?
 
     // check if print can be optimized out
     if ((*ctx->program)[prgsize - 2].as<Print_t>().unoptimizable)
-        return generate<Print_t>(ctx, print_escape, ctx->pos());
+        return generate_print_instr(ctx, print_escape);
 
     DBG(std::cerr << "$$$$ print optimization" << std::endl);
 
@@ -50,6 +50,12 @@ namespace Parser {
  */
 void generate_print(Context_t *ctx, bool print_escape = true);
 
+/** Replaces all generic print instructions with the instructions specialized
+ * for the content type open in compile time, so the escaping does not have to
+ * be resolved in runtime.
+ */
+void specialize_prints(Context_t *ctx);
+
 /** Generates lookup to dictionary instruction.
  */
 void generate_dict_lookup(Context_t *ctx, const Token_t &token);
@@ -49,6 +49,12 @@ namespace Teng {
 namespace Parser {
 namespace {
 
+/** Returns the name of variable interned by the program.
+ */
+const std::string *intern(Context_t *ctx, const Variable_t &var) {
+    return ctx->program->intern(var.ident.name().view());
+}
+
 /** Generates set var instruction.
  */
 void set_var_impl(Context_t *ctx, const Variable_t &var) {
@@ -115,7 +121,7 @@ void set_var_impl(Context_t *ctx, const Variable_t &var) {
     case LEX2::TYPE:
     case LEX2::COUNT:
     case LEX2::CASE:
-        generate<Set_t>(ctx, var);
+        generate<Set_t>(ctx, var, intern(ctx, var));
         break;
 
     default:
@@ -167,7 +173,7 @@ void generate_var_impl(Context_t *ctx, const Variable_t &var) {
     case LEX2::BUILTIN_ERROR:
         ctx->params->isErrorFragmentEnabled()
             ? generate<PushErrorFrag_t>(ctx, false, var.pos)
-            : generate<Var_t>(ctx, var, true);
+            : generate<Var_t>(ctx, var, intern(ctx, var), true);
         break;
 
     case LEX2::VAR:   // $ident
@@ -209,7 +215,7 @@ void generate_var_impl(Context_t *ctx, const Variable_t &var) {
     case LEX2::TYPE:
     case LEX2::COUNT:
     case LEX2::CASE:
-        generate<Var_t>(ctx, var, true);
+        generate<Var_t>(ctx, var, intern(ctx, var), true);
         break;
 
     default:
@@ -43,6 +43,7 @@
 #include <vector>
 #include <memory>
 
+#include "util.h"
 #include "position.h"
 #include "teng/error.h"
 #include "teng/filesystem.h"
@@ -95,6 +96,15 @@ public:
      */
     std::size_t size() const {return sources.size();}
 
+    /** @short Returns the estimated heap footprint of the list.
+     */
+    std::size_t memoryUsage() const {
+        auto size = sources.capacity() * sizeof(sources[0]);
+        for (auto &source: sources)
+            size += sizeof(FileStat_t) + heap_size(source->filename);
+        return size;
+    }
+
     /** @short Returns iterator to the first source.
      */
     auto begin() const {return sources.begin();}
@@ -34,17 +34,108 @@
  *             Created.
  */
 
+#include "util.h"
 #include "template.h"
+#include "tracespan.h"
 
 namespace Teng {
+namespace {
+
+/** Returns the reason of the reload.
+ */
+CacheEvent_t::Reason_t
+reload_reason(bool missing, bool depends_changed) {
+    return missing
+        ? CacheEvent_t::MISSING
+        : depends_changed
+        ? CacheEvent_t::DEPENDS_CHANGED
+        : CacheEvent_t::SOURCE_CHANGED;
+}
+
+} // namespace
 
 TemplateCache_t::TemplateCache_t(
     std::shared_ptr<const FilesystemInterface_t> filesystem,
     unsigned int programCacheSize,
-    unsigned int dictCacheSize
+    unsigned int dictCacheSize,
+    CacheCallback_t callback,
+    Tracer_t *tracer
 ): filesystem(filesystem), programCache(programCacheSize),
-   dictCache(dictCacheSize), paramsCache(dictCacheSize)
-{}
+   dictCache(dictCacheSize), paramsCache(dictCacheSize),
+   callback(std::move(callback)), tracer(tracer)
+{
+    programCache.onEvicted([this] (const ProgramCache_t::Key_t &key) {
+        if (programEvicted) programEvicted(key);
+        if (!this->callback) return;
+        this->callback({CacheEvent_t::PROGRAMS, CacheEvent_t::EVICTED, key[0]});
+    });
+    if (!this->callback) return;
+    dictCache.onEvicted([this] (const DictionaryCache_t::Key_t &key) {
+        this->callback({CacheEvent_t::DICTS, CacheEvent_t::EVICTED, key[1]});
+    });
+    paramsCache.onEvicted([this] (const ConfigurationCache_t::Key_t &key) {
+        this->callback({CacheEvent_t::PARAMS, CacheEvent_t::EVICTED, key[0]});
+    });
+}
+
+CachesStats_t TemplateCache_t::stats() const {
+    CachesStats_t result{
+        programCache.stats(),
+        dictCache.stats(),
+        paramsCache.stats()
+    };
+    result.programs.memory = programCache.memoryUsage();
+    result.dicts.memory = dictCache.memoryUsage();
+    result.params.memory = paramsCache.memoryUsage();
+    return result;
+}
+
+void TemplateCache_t::resetStats() {
+    programCache.stats() = {};
+    dictCache.stats() = {};
+    paramsCache.stats() = {};
+}
+
+template <typename cache_t>
+void TemplateCache_t::loaded(
+    cache_t &cache,
+    CacheEvent_t::CacheId_t id,
+    CacheEvent_t::Reason_t reason,
+    const std::string &key,
+    uint64_t time
+) {
+    auto &stats = cache.stats();
+    switch (reason) {
+    case CacheEvent_t::MISSING: ++stats.misses; break;
+    case CacheEvent_t::SOURCE_CHANGED: ++stats.changedReloads; break;
+    case CacheEvent_t::DEPENDS_CHANGED: ++stats.dependReloads; break;
+    case CacheEvent_t::EVICTED: break;
+    }
+    ++stats.loads;
+    stats.loadTime += time;
+    if (callback) callback({id, reason, key, time});
+}
+
+std::vector<std::string>
+TemplateCache_t::programKey(
+    const std::string &source,
+    const std::string &langFilename,
+    const std::string &configFilename,
+    const std::string &ctype,
+    SourceType_t sourceType
+) {
+    std::vector<std::string> key;
+    if (sourceType == SRC_STRING)
+        key.push_back(createCacheKeyForString(source));
+    else key.push_back(createCacheKeyForFilename(source));
+    key.push_back(createCacheKeyForFilename(langFilename));
+    key.push_back(createCacheKeyForFilename(configFilename));
+
+    // the string literals are escaped in compile time so the program depends
+    // on content type too
+    key.push_back(ctype);
+    return key;
+}
 
 Template_t
 TemplateCache_t::createTemplate(
@@ -64,12 +155,13 @@ TemplateCache_t::createTemplate(
         = getConfigAndDict(err, configFilename, langFilename);
 
     // create key from source file names
-    std::vector<std::string> key;
-    if (sourceType == SRC_STRING)
-        key.push_back(createCacheKeyForString(source));
-    else key.push_back(createCacheKeyForFilename(source));
-    key.push_back(createCacheKeyForFilename(langFilename));
-    key.push_back(createCacheKeyForFilename(configFilename));
+    auto key = programKey(
+        source,
+        langFilename,
+        configFilename,
+        ctype,
+        sourceType
+    );
 
     // cached program
     uint64_t dependSerial;
@@ -77,22 +169,41 @@ TemplateCache_t::createTemplate(
     std::tie(program, dependSerial, std::ignore) = programCache.find(key);
 
     // determine whether we have to reload program
-    bool reload = !program
-        || (configSerial != dependSerial)
+    bool missing = !program;
+    bool depends_changed = !missing && (configSerial != dependSerial);
+    bool reload = missing || depends_changed
         || (params->isWatchFilesEnabled() && program->isChanged(filesystem.get()));
 
     // create new program if reload requested
     if (reload) {
         auto *d = &*dict;
         auto *p = &*params;
-        program = (sourceType == SRC_STRING)
-            ? compile_string(err, d, p, filesystem.get(), {source}, encoding, ctype)
-            : compile_file(err, d, p, filesystem.get(), source, encoding, ctype);
+        auto *fs = filesystem.get();
+        if (sourceType == SRC_STRING) {
+            TraceSpan_t span(tracer, Tracer_t::COMPILE);
+            program = compile_string(
+                err, d, p, fs, {source}, encoding, ctype, tracer
+            );
+        } else {
+            TraceSpan_t span(tracer, Tracer_t::COMPILE, source);
+            program = compile_file(
+                err, d, p, fs, source, encoding, ctype, tracer
+            );
+        }
+        auto reason = reload_reason(missing, depends_changed);
+        auto id = CacheEvent_t::PROGRAMS;
+        loaded(programCache, id, reason, key[0], program->compileTime());
         programCache.add(key, program, configSerial);
-    }
+    } else ++programCache.stats().hits;
 
     // create template with cached sources
-    return {std::move(program), std::move(dict), std::move(params)};
+    return {
+        std::move(program),
+        std::move(dict),
+        std::move(params),
+        std::move(key),
+        reload
+    };
 }
 
 std::tuple<
@@ -115,15 +226,20 @@ std::tuple<
     std::tie(params, std::ignore, configSerial) = paramsCache.find(key);
 
     // determine whether we have to reload params
-    bool reload_params = !params
+    bool missing_params = !params;
+    bool reload_params = missing_params
         || (params->isWatchFilesEnabled() && params->isChanged());
 
     // reload params if needed
     if (reload_params) {
+        auto start = Clock_t::now();
         params = std::make_shared<Configuration_t>(err, filesystem);
         if (!configFilename.empty()) params->parse(configFilename);
+        auto reason = reload_reason(missing_params, false);
+        auto id = CacheEvent_t::PARAMS;
+        loaded(paramsCache, id, reason, key[0], elapsed(start));
         configSerial = paramsCache.add(key, params);
-    }
+    } else ++paramsCache.stats().hits;
 
     // reuse key for dictionary
     key.push_back(createCacheKeyForFilename(dictFilename));
@@ -135,16 +251,21 @@ std::tuple<
     std::tie(dict, dependSerial, dictSerial) = dictCache.find(key);
 
     // determine whether we have to reload dict
-    bool reload_dict = !dict
-        || (configSerial != dependSerial)
+    bool missing_dict = !dict;
+    bool depends_changed = !missing_dict && (configSerial != dependSerial);
+    bool reload_dict = missing_dict || depends_changed
         || (params->isWatchFilesEnabled() && dict->isChanged());
 
     // reload lang dict if needed
     if (reload_dict) {
+        auto start = Clock_t::now();
         dict = std::make_shared<Dictionary_t>(err, filesystem);
         if (!dictFilename.empty()) dict->parse(dictFilename);
+        auto reason = reload_reason(missing_dict, depends_changed);
+        auto id = CacheEvent_t::DICTS;
+        loaded(dictCache, id, reason, key[1], elapsed(start));
         dictCache.add(key, dict, configSerial);
-    }
+    } else ++dictCache.stats().hits;
 
     // return data
     return {std::move(params), std::move(dict), configSerial};
@@ -41,12 +41,14 @@
 #include <memory>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include "cache.h"
 #include "dictionary.h"
 #include "program.h"
 #include "parsercontext.h"
 #include "configuration.h"
+#include "teng/tracer.h"
 
 namespace Teng {
 
@@ -60,6 +62,8 @@ public:
     std::shared_ptr<const Program_t> program;      //!< bytecode of the template
     std::shared_ptr<const Dictionary_t> dict;      //!< language dictionary
     std::shared_ptr<const Configuration_t> params; //!< config dictionary
+    std::vector<std::string> key;                  //!< the program cache key
+    bool compiled = false; //!< true if program has just been compiled
 };
 
 /** @short Cache of templates.
@@ -78,16 +82,25 @@ public:
      */
     using ProgramCache_t = Cache_t<Program_t>;
 
+    /** @short Called with the key of each evicted program.
+     */
+    using ProgramEvicted_t
+        = std::function<void (const ProgramCache_t::Key_t &)>;
+
     /** @short Create new cache.
      *
      *  @param fs_root root dir for relative paths
      *  @param programCacheSize maximal number of programs in the cache
      *  @param dictCacheSizemaximal number of dictionaries in the cache
+     *  @param callback called on each load or eviction of cache entry
+     *  @param tracer receives the compilation phases (can be nullptr)
      */
     TemplateCache_t(
         std::shared_ptr<const FilesystemInterface_t> filesystem,
         unsigned int programCacheSize = 0,
-        unsigned int dictCacheSize = 0
+        unsigned int dictCacheSize = 0,
+        CacheCallback_t callback = {},
+        Tracer_t *tracer = nullptr
     );
 
     /** @short Type of source.
@@ -115,6 +128,28 @@ public:
         SourceType_t sourceType
     );
 
+    /** @short Returns the cached program of the template or nullptr if it
+     *  isn't cached. Nothing is compiled and neither the cache counters nor
+     *  the lru are touched.
+     *  @param templateSource source of template
+     *  @param langFilename file with language dictionary
+     *  @param paramFilename file with config
+     *  @param sourceType type of template source
+     *  @return the cached program or nullptr
+     */
+    std::shared_ptr<const Program_t>
+    findProgram(
+        const std::string &source,
+        const std::string &langFilename,
+        const std::string &paramFilename,
+        const std::string &ctype,
+        SourceType_t sourceType
+    ) const {
+        return programCache.peek(
+            programKey(source, langFilename, paramFilename, ctype, sourceType)
+        );
+    }
+
     /** @short Create dictionary from given files.
      *
      *  @param configFilename file with configuration
@@ -130,11 +165,38 @@ public:
         return std::get<1>(getConfigAndDict(err, configFilename, dictFilename));
     }
 
+    /** @short Returns the counters of all caches and the estimated heap
+     *  footprint of cached programs and dictionaries.
+     */
+    CachesStats_t stats() const;
+
+    /** @short Resets the counters of all caches.
+     */
+    void resetStats();
+
+    /** @short Sets the internal callback called on each eviction of program,
+     *  it is called before the user callback.
+     */
+    void onProgramEvicted(ProgramEvicted_t hook) {
+        programEvicted = std::move(hook);
+    }
+
 private:
     // don't copy
     TemplateCache_t(const TemplateCache_t &) = delete;
     TemplateCache_t &operator=(const TemplateCache_t &) = delete;
 
+    /** @short Returns the key of the template in the program cache.
+     */
+    static std::vector<std::string>
+    programKey(
+        const std::string &source,
+        const std::string &langFilename,
+        const std::string &configFilename,
+        const std::string &ctype,
+        SourceType_t sourceType
+    );
+
     /** @short Get configuration and dictionary from given files.
      *
      *  @param configFilename file with configuration
@@ -153,10 +215,25 @@ private:
         uint64_t *serial = nullptr
     );
 
+    /** @short Updates counters of the cache after the load of entry and
+     *  calls the callback.
+     */
+    template <typename cache_t>
+    void loaded(
+        cache_t &cache,
+        CacheEvent_t::CacheId_t id,
+        CacheEvent_t::Reason_t reason,
+        const std::string &key,
+        uint64_t time
+    );
+
     std::shared_ptr<const FilesystemInterface_t> filesystem;
     ProgramCache_t programCache;      //!< cache of compiled templates
     DictionaryCache_t dictCache;      //!< cache of parsed language dictionaries
     ConfigurationCache_t paramsCache; //!< cahce of parsed config dictionaries
+    CacheCallback_t callback;         //!< called on each load or eviction
+    ProgramEvicted_t programEvicted;  //!< called on each program eviction
+    Tracer_t *tracer;                 //!< receives the compilation phases
 };
 
 } // namespace Teng
@@ -38,6 +38,11 @@
 
 #include <unistd.h>
 
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
 #include <stdexcept>
 #include <memory>
 
@@ -46,7 +51,10 @@
 #include "logging.h"
 #include "processor.h"
 #include "template.h"
+#include "tracespan.h"
 #include "teng/structs.h"
+#include "teng/value.h"
+#include "teng/datasource.h"
 #include "teng/teng.h"
 #include "teng/filesystem.h"
 
@@ -80,76 +88,329 @@ std::string prependBeforeExt(const std::string &str, const std::string &prep) {
     }
 }
 
+/** Writer adapter that counts the bytes passed to the underlying writer.
+ */
+class CountingWriter_t: public Writer_t {
+public:
+    CountingWriter_t(Writer_t &writer)
+        : writer(writer), written(0)
+    {}
+
+    int write(const std::string &str) override {
+        written += str.size();
+        return writer.write(str);
+    }
+
+    int write(const char *str) override {
+        written += strlen(str);
+        return writer.write(str);
+    }
+
+    int write(const char *str, std::size_t size) override {
+        written += size;
+        return writer.write(str, size);
+    }
+
+    int write(const std::string &str, StringSpan_t interval) override {
+        written += std::distance(interval.first, interval.second);
+        return writer.write(str, interval);
+    }
+
+    int flush() override {return writer.flush();}
+
+    void reserve(std::size_t size) override {writer.reserve(size);}
+
+    int writeLiteral(const char *str, std::size_t size) override {
+        written += size;
+        return writer.writeLiteral(str, size);
+    }
+
+    /** Returns the number of bytes written so far.
+     */
+    std::size_t size() const {return written;}
+
+private:
+    Writer_t &writer;    //!< underlying writer
+    std::size_t written; //!< the number of written bytes
+};
+
+/** Render statistics of one template and the window of its recent render
+ * times.
+ */
+struct StatsRecord_t {
+    Teng_t::TemplateStats_t stats; //!< the cumulative stats
+    std::vector<uint64_t> recent;  //!< the recent render times
+    std::size_t next = 0;          //!< the oldest render time in full window
+
+    /** Remembers the render time.
+     */
+    void push(uint64_t time) {
+        if (recent.size() < Teng_t::STATS_WINDOW) recent.push_back(time);
+        else recent[next++ % Teng_t::STATS_WINDOW] = time;
+    }
+
+    /** Returns the stats with percentiles of recent render times.
+     */
+    Teng_t::TemplateStats_t snapshot() const {
+        auto result = stats;
+        if (recent.empty()) return result;
+        auto sorted = recent;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&] (std::size_t p) {
+            auto rank = (p * sorted.size() + 99) / 100;
+            return sorted[std::max<std::size_t>(rank, 1) - 1];
+        };
+        result.renderTimeP50 = percentile(50);
+        result.renderTimeP99 = percentile(99);
+        return result;
+    }
+};
+
 } // namespace
 
 struct Teng_t::PTeng_t {
-    PTeng_t(std::unique_ptr<TemplateCache_t> templateCache)
-        : templateCache(std::move(templateCache))
-    {}
+    PTeng_t(
+        std::unique_ptr<TemplateCache_t> templateCache,
+        bool collectStats,
+        std::shared_ptr<Tracer_t> tracer
+    ): templateCache(std::move(templateCache)), collectStats(collectStats),
+       tracer(std::move(tracer))
+    {
+        // the stats of evicted programs would grow without limit
+        if (!collectStats) return;
+        this->templateCache->onProgramEvicted([this] (const auto &key) {
+            std::lock_guard<std::mutex> locked(statsMutex);
+            stats.erase(key);
+        });
+    }
     ~PTeng_t() = default;
 
-    std::unique_ptr<TemplateCache_t> templateCache; //!< cache of dicts and templates
-};
+    /** Returns the template (compiled program and dictionaries) for given
+     * args. The encoding must be already lowerized.
+     */
+    Template_t createTemplate(
+        const GenPageArgs_t &args,
+        const std::string &encoding,
+        Error_t &err
+    ) {
+        auto phase = Tracer_t::CACHE_LOOKUP;
+        TraceSpan_t span(tracer.get(), phase, args.templateFilename);
+        return templateCache->createTemplate(
+            err,
+            templateSource(args),
+            prependBeforeExt(args.dictFilename, args.lang),
+            args.paramsFilename,
+            encoding,
+            args.contentType,
+            sourceType(args)
+        );
+    }
 
-Teng_t::Teng_t(const std::string& fs_root, const Teng_t::Settings_t& settings)
-    : Teng_t(std::make_shared<Filesystem_t>(fs_root), settings)
-{}
+    /** Returns the cached program of the template or nullptr.
+     */
+    std::shared_ptr<const Program_t>
+    findProgram(const GenPageArgs_t &args) const {
+        return templateCache->findProgram(
+            templateSource(args),
+            prependBeforeExt(args.dictFilename, args.lang),
+            args.paramsFilename,
+            args.contentType,
+            sourceType(args)
+        );
+    }
 
-Teng_t::Teng_t(std::shared_ptr<FilesystemInterface_t> fs, const Settings_t& settings)
-    : p(std::make_unique<Teng_t::PTeng_t>(
-        std::make_unique<TemplateCache_t>(fs, settings.programCacheSize, settings.dictCacheSize)))
-{}
+    /** Returns the template string or the template filename with skin.
+     */
+    static std::string templateSource(const GenPageArgs_t &args) {
+        return args.templateFilename.empty()
+            ? args.templateString
+            : prependBeforeExt(args.templateFilename, args.skin);
+    }
 
-Teng_t::~Teng_t() = default;
+    /** Returns the type of the template source.
+     */
+    static TemplateCache_t::SourceType_t
+    sourceType(const GenPageArgs_t &args) {
+        return args.templateFilename.empty()
+            ? TemplateCache_t::SRC_STRING
+            : TemplateCache_t::SRC_FILE;
+    }
 
-int Teng_t::generatePage(
+    /** Renders the template for given args and root fragment of data.
+     */
+    int generatePage(
+        const GenPageArgs_t &args,
+        const Value_t &root,
+        Writer_t &writer,
+        Error_t &err
+    );
+
+    /** Adds the compilation and the render of the template to its stats.
+     */
+    void record(
+        const Template_t &templ,
+        uint64_t renderTime,
+        uint64_t bytes,
+        uint64_t instructions
+    ) {
+        std::lock_guard<std::mutex> locked(statsMutex);
+        auto &record = stats[templ.key];
+        if (!record.stats.renders && !record.stats.compiles) {
+            record.stats.source = templ.key[0];
+            record.stats.dictFilename = templ.key[1];
+            record.stats.paramsFilename = templ.key[2];
+            record.stats.contentType = templ.key[3];
+        }
+        if (templ.compiled) {
+            ++record.stats.compiles;
+            record.stats.compileTime += templ.program->compileTime();
+        }
+        ++record.stats.renders;
+        record.stats.renderTime += renderTime;
+        record.stats.bytes += bytes;
+        record.stats.instructions += instructions;
+        record.push(renderTime);
+    }
+
+    std::unique_ptr<TemplateCache_t> templateCache; //!< cache of dicts and templates
+    bool collectStats;                              //!< collect render stats
+    std::shared_ptr<Tracer_t> tracer;               //!< receives render phases
+    std::mutex statsMutex;                          //!< guards the stats
+    std::map<std::vector<std::string>, StatsRecord_t> stats; //!< the stats
+};
+
+int Teng_t::PTeng_t::generatePage(
     const GenPageArgs_t &args,
-    const Fragment_t &data,
+    const Value_t &root,
     Writer_t &writer,
     Error_t &err
-) const {
+) {
+    auto start = Clock_t::now();
     std::string encoding_lowerized = tolower(args.encoding);
 
-    // prepare template
-    std::string template_arg = args.templateFilename.empty()
-        ? args.templateString
-        : prependBeforeExt(args.templateFilename, args.skin);
-
     // create template
-    auto templ = p->templateCache->createTemplate(
-        err,
-        template_arg,
-        prependBeforeExt(args.dictFilename, args.lang),
-        args.paramsFilename,
-        encoding_lowerized,
-        args.contentType,
-        args.templateFilename.empty()
-            ? TemplateCache_t::SRC_STRING
-            : TemplateCache_t::SRC_FILE
-    );
+    auto templ = createTemplate(args, encoding_lowerized, err);
 
     // propage error log
     writer.setError(&err);
 
     // if program is valid (not empty) execute it
+    uint64_t bytes = 0;
+    uint64_t instructions = 0;
     if (!templ.program->empty()) {
-        Processor_t(
+        auto phase = Tracer_t::EXECUTE;
+        TraceSpan_t span(tracer.get(), phase, args.templateFilename);
+        Processor_t processor(
             err,
             *templ.program,
             *templ.dict,
             *templ.params,
             encoding_lowerized,
             args.contentType
-        ).run(FragmentValue_t(&data), writer);
+        );
+
+        if (args.reserveOutput) {
+            // reserve space for the page (plus some slack for the growth)
+            if (auto size = templ.program->estimatedOutputSize())
+                writer.reserve(size + size / 8);
+
+            // run program and remember the size of page for next time
+            CountingWriter_t counter(writer);
+            counter.setError(&err);
+            processor.run(root, counter, args.profile, collectStats);
+            templ.program->updateOutputSize(counter.size());
+            bytes = counter.size();
+
+        } else if (collectStats) {
+            // run program and count the bytes of page
+            CountingWriter_t counter(writer);
+            counter.setError(&err);
+            processor.run(root, counter, args.profile, true);
+            bytes = counter.size();
+
+        } else {
+            processor.run(root, writer, args.profile);
+        }
+        instructions = processor.executedInstructions();
     }
 
     // flush writer to output
-    writer.flush();
+    {
+        TraceSpan_t span(tracer.get(), Tracer_t::FLUSH);
+        writer.flush();
+    }
+
+    // the compilation of the template is accounted separately
+    if (collectStats) {
+        auto compileTime = templ.compiled? templ.program->compileTime(): 0;
+        auto renderTime = elapsed(start) - compileTime;
+        record(templ, renderTime, bytes, instructions);
+    }
 
     // return error level from error log
     return err.max_level;
 }
 
+Teng_t::Teng_t(const std::string& fs_root, const Teng_t::Settings_t& settings)
+    : Teng_t(std::make_shared<Filesystem_t>(fs_root), settings)
+{}
+
+Teng_t::Teng_t(std::shared_ptr<FilesystemInterface_t> fs, const Settings_t& settings)
+    : p(std::make_unique<Teng_t::PTeng_t>(
+        std::make_unique<TemplateCache_t>(
+            fs,
+            settings.programCacheSize,
+            settings.dictCacheSize,
+            settings.cacheCallback,
+            settings.tracer.get()
+        ), settings.collectStats, settings.tracer))
+{}
+
+Teng_t::~Teng_t() = default;
+
+int Teng_t::generatePage(
+    const GenPageArgs_t &args,
+    const Fragment_t &data,
+    Writer_t &writer,
+    Error_t &err
+) const {return p->generatePage(args, Value_t(&data), writer, err);}
+
+int Teng_t::generatePage(
+    const GenPageArgs_t &args,
+    const DataSource_t &data,
+    Writer_t &writer,
+    Error_t &err
+) const {return p->generatePage(args, data.root(), writer, err);}
+
+std::vector<Teng_t::TemplateStats_t> Teng_t::templateStats() const {
+    std::lock_guard<std::mutex> locked(p->statsMutex);
+    std::vector<TemplateStats_t> result;
+    result.reserve(p->stats.size());
+    for (auto &entry: p->stats)
+        result.push_back(entry.second.snapshot());
+    return result;
+}
+
+void Teng_t::resetTemplateStats() {
+    std::lock_guard<std::mutex> locked(p->statsMutex);
+    p->stats.clear();
+}
+
+CachesStats_t Teng_t::cacheStats() const {
+    return p->templateCache->stats();
+}
+
+void Teng_t::resetCacheStats() {
+    p->templateCache->resetStats();
+}
+
+CompileReport_t Teng_t::compileReport(const GenPageArgs_t &args) const {
+    if (auto program = p->findProgram(args))
+        if (auto *report = program->compileReport())
+            return *report;
+    return CompileReport_t();
+}
+
 const std::string *Teng_t::dictionaryLookup(
     const std::string &config,
     const std::string &dict,
@@ -0,0 +1,80 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng trace span.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGTRACESPAN_H
+#define TENGTRACESPAN_H
+
+#include <string>
+
+#include "teng/tracer.h"
+
+namespace Teng {
+
+/** Reports the begin of the phase to the tracer when it is created and the
+ * end of the phase when it is destroyed. It costs one pointer check if
+ * there is no tracer.
+ */
+class TraceSpan_t {
+public:
+    /** C'tor.
+     */
+    TraceSpan_t(
+        Tracer_t *tracer,
+        Tracer_t::Phase_t phase,
+        const std::string &detail = {}
+    ): tracer(tracer), phase(phase)
+    {
+        if (tracer) tracer->begin(phase, detail);
+    }
+
+    /** D'tor.
+     */
+    ~TraceSpan_t() {if (tracer) tracer->end(phase);}
+
+    // don't copy
+    TraceSpan_t(const TraceSpan_t &) = delete;
+    TraceSpan_t &operator=(const TraceSpan_t &) = delete;
+
+private:
+    Tracer_t *tracer;        //!< the tracer or nullptr
+    Tracer_t::Phase_t phase; //!< the traced phase
+};
+
+} // namespace Teng
+
+#endif /* TENGTRACESPAN_H */
+
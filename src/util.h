@@ -38,10 +38,24 @@
 #ifndef TENGUTIL_H
 #define TENGUTIL_H
 
+#include <chrono>
 #include <string>
+#include <cstdint>
 
 namespace Teng {
 
+/** @short The clock of all time measurements (stats, profiles, reports).
+ */
+using Clock_t = std::chrono::steady_clock;
+
+/** @short Returns the time elapsed since start in nanoseconds.
+ */
+inline uint64_t elapsed(Clock_t::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock_t::now() - start
+    ).count();
+}
+
 /** @short Normalizes filename.
  *
  * Removes multiple '/', removes '.', resolves '..'.  Path must be
@@ -72,6 +86,14 @@ std::string tolower(std::string str);
  */
 std::string strerr(int errno_value);
 
+/** @short Returns the estimated number of bytes the string allocates on
+ *  the heap. The short strings are stored inside the string object.
+ */
+inline std::size_t heap_size(const std::string &str) {
+    static const auto local_capacity = std::string().capacity();
+    return str.capacity() > local_capacity? str.capacity() + 1: 0;
+}
+
 } // namespace Teng
 
 #endif // TENGUTIL_H
@@ -46,6 +46,7 @@
 #include "platform.h"
 #include "formatter.h"
 #include "regex.h"
+#include "datanode.h"
 #include "teng/structs.h"
 #include "teng/value.h"
 
@@ -74,7 +75,7 @@ Value_t::Value_t(const FragmentValue_t *value) noexcept {
         new (this) Value_t(&value->list_value);
         break;
     case FragmentValue_t::tag::frag_ptr:
-        new (this) Value_t(value->frag_ptr_value);
+        new (this) Value_t(value->frag_ptr_value.get());
         break;
     case FragmentValue_t::tag::frag:
         new (this) Value_t(&value->frag_value);
@@ -109,11 +110,37 @@ void Value_t::json(std::ostream &out) const {
     case Value_t::tag::string_ref:
         json::quote_string(out, string_ref_value);
         break;
-    case Value_t::tag::frag_ref:
-        frag_ref_value.ptr->json(out);
+    case Value_t::tag::frag_ref: {
+        if (!frag_ref_value.source) {
+            frag_ref_value.frag()->json(out);
+            break;
+        }
+        bool first = true;
+        out << '{';
+        for_each_attr(frag_ref_value, [&] (
+            const string_view_t &name,
+            const Value_t &value
+        ) {
+            if (!first) out << ", ";
+            first = false;
+            json::quote_string(out, name);
+            out << ": ";
+            value.json(out);
+        });
+        out << '}';
         break;
+    }
     case Value_t::tag::list_ref:
-        list_ref_value.ptr->json(out);
+        if (!list_ref_value.source) {
+            list_ref_value.list()->json(out);
+            break;
+        }
+        out << '[';
+        for (std::size_t i = 0; i < list_size(list_ref_value); ++i) {
+            if (i) out << ", ";
+            list_item(list_ref_value, i).json(out);
+        }
+        out << ']';
         break;
     case Value_t::tag::regex:
         out << "null";
@@ -144,7 +171,7 @@ std::ostream &operator<<(std::ostream &out, const Value_t &v) {
     case Value_t::tag::list_ref:
         out << "list_ref(@" << v.list_ref_value.ptr
             << ',' << v.list_ref_value.i
-            << ',' << v.list_ref_value.ptr->size() << ')';
+            << ',' << list_size(v.list_ref_value) << ')';
         break;
     case Value_t::tag::regex:
         out << "regex(" << *v.regex_value << ')';
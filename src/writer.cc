@@ -67,6 +67,12 @@ int StringWriter_t::write(const std::string &, StringSpan_t interval) {
     return 0;
 }
 
+void StringWriter_t::reserve(std::size_t size) {
+    // string::reserve() may shrink the string in C++17
+    if (str.capacity() < str.size() + size)
+        str.reserve(str.size() + size);
+}
+
 FileWriter_t::FileWriter_t(const std::string &filename)
     : file(fopen(filename.c_str(), "w")), borrowed(false)
 {
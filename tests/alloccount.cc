@@ -0,0 +1,132 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Counting replacement of the global allocator.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+#include "alloccount.h"
+
+namespace {
+
+std::atomic<uint64_t> alloc_count{0}; //!< the number of allocations
+std::atomic<uint64_t> alloc_bytes{0}; //!< the number of allocated bytes
+
+/** Counts and allocates the memory.
+ */
+void *counted_alloc(std::size_t size) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto *ptr = std::malloc(size? size: 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+/** Counts and allocates the aligned memory.
+ */
+void *counted_alloc(std::size_t size, std::align_val_t align) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    auto alignment = static_cast<std::size_t>(align);
+    size = (size + alignment - 1) / alignment * alignment;
+    if (auto *ptr = std::aligned_alloc(alignment, size? size: alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+namespace Teng {
+namespace test {
+
+AllocStats_t alloc_stats() {
+    return {
+        alloc_count.load(std::memory_order_relaxed),
+        alloc_bytes.load(std::memory_order_relaxed)
+    };
+}
+
+} // namespace test
+} // namespace Teng
+
+void *operator new(std::size_t size) {
+    return counted_alloc(size);
+}
+
+void *operator new[](std::size_t size) {
+    return counted_alloc(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+    return counted_alloc(size, align);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align) {
+    return counted_alloc(size, align);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,68 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Counting replacement of the global allocator.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#ifndef TENGALLOCCOUNT_H
+#define TENGALLOCCOUNT_H
+
+#include <cstdint>
+
+namespace Teng {
+namespace test {
+
+/** The numbers of allocations done through the global operator new since
+ * the program start. The memory allocated by C libraries (pcre, glib) is not
+ * counted.
+ */
+struct AllocStats_t {
+    /** Returns the allocations done between other and this snapshot.
+     */
+    AllocStats_t operator-(const AllocStats_t &other) const {
+        return {count - other.count, bytes - other.bytes};
+    }
+
+    uint64_t count; //!< the number of allocations
+    uint64_t bytes; //!< the number of allocated bytes
+};
+
+/** Returns the current allocation counters.
+ */
+AllocStats_t alloc_stats();
+
+} // namespace test
+} // namespace Teng
+
+#endif /* TENGALLOCCOUNT_H */
@@ -0,0 +1,192 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- allocations of the render path.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <teng/teng.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "alloccount.h"
+#include "utils.h"
+
+namespace {
+
+/** The reference template.
+ */
+struct Reference_t {
+    const char *name;     //!< the reference name
+    const char *templ;    //!< the template rendered for each row
+};
+
+/** The reference templates.
+ *
+ * There are no allocation budgets yet, the test only measures and reports
+ * the allocations. Run it with TENG_ALLOC_REPORT=1 to print the numbers;
+ * the budgets should be asserted once they are measured on the supported
+ * platforms.
+ */
+const Reference_t references[] = {
+    {
+        "listing",
+        "<?teng frag row?><li><a href='${url}?id=${id}'>${name}</a> "
+        "<?teng if _first?>first<?teng elseif _last?>last<?teng endif?>"
+        "</li>\n<?teng endfrag?>"
+    }, {
+        "escaping",
+        "<?teng frag row?><p title='${text}'>${text}</p>"
+        "<?teng ctype 'quoted-string'?>${text}<?teng endctype?>\n"
+        "<?teng endfrag?>"
+    }, {
+        "expressions",
+        "<?teng frag row?>"
+        "<?teng if id % 2 == 0 && price > 100?>${numformat(price, 2)}"
+        "<?teng elseif name =~ /7/?>${len(name)}"
+        "<?teng else?>${id > 50? 'big': 'small'}<?teng endif?>\n"
+        "<?teng endfrag?>"
+    }, {
+        "dictionary",
+        "<?teng frag row?>#{hello_world}: ${#html_value}\n<?teng endfrag?>"
+    }, {
+        "locals",
+        "<?teng frag row?><?teng set total = price * 2?>"
+        "<?teng set label = 'x'?>${total}${label}\n<?teng endfrag?>"
+    },
+};
+
+/** Returns data with given number of rows.
+ */
+Teng::Fragment_t make_data(std::size_t rows) {
+    Teng::Fragment_t root;
+    for (std::size_t i = 0; i < rows; ++i) {
+        auto &row = root.addFragment("row");
+        row.addVariable("id", static_cast<Teng::IntType_t>(i));
+        row.addVariable("name", "product " + std::to_string(i));
+        row.addVariable("url", "https://example.com/product");
+        row.addVariable("price", static_cast<Teng::IntType_t>(i * 7));
+        row.addVariable("text", "<b>bold</b> & \"quoted\" text");
+    }
+    return root;
+}
+
+/** Renders the page and returns the allocations done by the render. The
+ * output buffer is reserved in advance so only the engine is measured.
+ */
+Teng::test::AllocStats_t render(
+    Teng::Teng_t &teng,
+    const Reference_t &ref,
+    const Teng::Fragment_t &data
+) {
+    Teng::Teng_t::GenPageArgs_t args;
+    args.templateString = ref.templ;
+    args.dictFilename = "dict.txt";
+    args.paramsFilename = "teng.conf";
+    Teng::Error_t err;
+    std::string result;
+    result.reserve(1024 * 1024);
+    Teng::StringWriter_t writer(result);
+
+    auto start = Teng::test::alloc_stats();
+    teng.generatePage(args, data, writer, err);
+    auto allocs = Teng::test::alloc_stats() - start;
+
+    INFO(ref.name << ": " << err);
+    REQUIRE(err.max_level < Teng::Error_t::ERROR);
+    return allocs;
+}
+
+} // namespace
+
+SCENARIO(
+    "The allocation counter",
+    "[allocs]"
+) {
+    GIVEN("Snapshot of counters") {
+        auto start = Teng::test::alloc_stats();
+
+        WHEN("Some memory is allocated") {
+            auto *ptr = new std::string(1000, 'x');
+            auto allocs = Teng::test::alloc_stats() - start;
+            delete ptr;
+
+            THEN("The allocations are counted") {
+                REQUIRE(allocs.count >= 2);
+                REQUIRE(allocs.bytes >= 1000);
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Allocations of reference templates",
+    "[allocs]"
+) {
+    // set TENG_ALLOC_REPORT=1 to print the measured numbers
+    bool report = std::getenv("TENG_ALLOC_REPORT");
+    auto small = make_data(100);
+    auto large = make_data(200);
+
+    for (auto &ref: references) {
+        DYNAMIC_SECTION("Given warmed up engine and " << ref.name) {
+            Teng::Teng_t teng(TEST_ROOT);
+            render(teng, ref, small);
+
+            WHEN("Pages of different number of rows are rendered") {
+                auto small_allocs = render(teng, ref, small);
+                auto large_allocs = render(teng, ref, large);
+                auto per_row
+                    = (double(large_allocs.count) - double(small_allocs.count))
+                    / 100.0;
+                auto per_render = double(small_allocs.count) - 100 * per_row;
+                if (report) {
+                    std::cout << "{\"template\": \"" << ref.name << "\""
+                              << ", \"allocs_per_row\": " << per_row
+                              << ", \"allocs_per_render\": " << per_render
+                              << ", \"allocs\": " << small_allocs.count
+                              << ", \"bytes\": " << small_allocs.bytes
+                              << "}" << std::endl;
+                }
+
+                THEN("The larger page does not allocate less") {
+                    INFO(ref.name << ": per row " << per_row
+                         << ", per render " << per_render);
+                    REQUIRE(large_allocs.count >= small_allocs.count);
+                }
+            }
+        }
+    }
+}
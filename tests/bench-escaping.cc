@@ -0,0 +1,111 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- benchmarks of escaping and unescaping.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <string>
+#include <teng/teng.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "utils.h"
+
+namespace {
+
+/** Returns printable characters (and newline) that are escaped in given
+ * content type and that survive the escape/unescape round trip.
+ */
+std::string escapable(const std::string &ct) {
+    std::string result;
+    auto e = "<?teng ctype '" + ct + "'?>${c}<?teng endctype?>";
+    auto u = "<?teng ctype '" + ct + "'?>%{unescape($c)}<?teng endctype?>";
+    std::string chars = "\n";
+    for (char c = 0x20; c <= 0x7e; ++c) chars.push_back(c);
+    for (char c: chars) {
+        Teng::Fragment_t root;
+        root.addVariable("c", std::string(1, c));
+        auto escaped = g(e, root);
+        if (escaped == std::string(1, c)) continue;
+        Teng::Fragment_t escaped_root;
+        escaped_root.addVariable("c", escaped);
+        if (g(u, escaped_root) == std::string(1, c)) result.push_back(c);
+    }
+    return result;
+}
+
+/** Returns text where approximately every eighth character is escapable.
+ */
+std::string make_text(const std::string &specials, std::size_t size) {
+    std::string result;
+    result.reserve(size);
+    for (std::size_t i = 0; result.size() < size; ++i) {
+        if ((i % 8) || specials.empty())
+            result.push_back(char('a' + i % 26));
+        else result.push_back(specials[(i / 8) % specials.size()]);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE(
+    "Benchmark of escaping and unescaping in all content types",
+    "[benchmark][escaping]"
+) {
+    for (auto &content_type: Teng::Teng_t::listSupportedContentTypes()) {
+        auto &ct = content_type.first;
+        auto text = make_text(escapable(ct), 16 * 1024);
+        Teng::Fragment_t root;
+        root.addVariable("s", text);
+
+        // escape variable value at runtime
+        auto e = "<?teng ctype '" + ct + "'?>${s}<?teng endctype?>";
+        auto escaped = g(e, root);
+        REQUIRE(escaped.size() >= text.size());
+
+        // unescape already escaped value
+        Teng::Fragment_t escaped_root;
+        escaped_root.addVariable("s", escaped);
+        auto u = "<?teng ctype '" + ct + "'?>%{unescape($s)}<?teng endctype?>";
+        REQUIRE(g(u, escaped_root) == text);
+
+        BENCHMARK("escape " + ct) {
+            return g(e, root);
+        };
+
+        BENCHMARK("unescape " + ct) {
+            return g(u, escaped_root);
+        };
+    }
+}
@@ -0,0 +1,443 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- benchmarks of building and rendering data trees.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+#include <teng/teng.h>
+#include <teng/flatmap.h>
+#include <teng/datasource.h>
+#include <teng/jsondocument.h>
+#include <teng/fragmentimage.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "utils.h"
+
+namespace {
+
+/** Fills data tree with given number of rows.
+ */
+void fill_rows(Teng::Fragment_t &root, std::size_t count) {
+    root.addVariable("title", "Products");
+    for (std::size_t i = 0; i < count; ++i) {
+        auto &row = root.addFragment("row");
+        row.addVariable("id", static_cast<Teng::IntType_t>(i));
+        row.addVariable("name", "product name");
+        row.addVariable("description", "some longer product description");
+        row.addVariable("price", 1999);
+        row.addVariable("url", "https://example.com/product");
+        row.addVariable("available", 1);
+        row.addFragment("tag").addVariable("name", "new");
+    }
+}
+
+/** Builds data tree with given number of rows.
+ */
+Teng::Fragment_t make_rows(std::size_t count) {
+    Teng::Fragment_t root;
+    fill_rows(root, count);
+    return root;
+}
+
+/** Appends given number of rows without nested fragments one by one.
+ */
+void fill_flat_rows(Teng::FragmentList_t &rows, std::size_t count) {
+    rows.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto &row = rows.addFragment();
+        row.addVariable("id", static_cast<Teng::IntType_t>(i));
+        row.addVariable("name", "product name");
+        row.addVariable("description", "some longer product description");
+        row.addVariable("price", 1999);
+        row.addVariable("url", "https://example.com/product");
+        row.addVariable("available", 1);
+    }
+}
+
+/** Fills columns with the same rows as fill_flat_rows().
+ */
+void fill_columns(Teng::FragmentColumns_t &columns, std::size_t count) {
+    std::vector<Teng::IntType_t> ids(count);
+    for (std::size_t i = 0; i < count; ++i)
+        ids[i] = static_cast<Teng::IntType_t>(i);
+    columns.addColumn("id", std::move(ids));
+    columns.addColumn("name", std::vector<std::string>(count, "product name"));
+    columns.addColumn(
+        "description",
+        std::vector<std::string>(count, "some longer product description")
+    );
+    columns.addColumn("price", std::vector<Teng::IntType_t>(count, 1999));
+    columns.addColumn(
+        "url",
+        std::vector<std::string>(count, "https://example.com/product")
+    );
+    columns.addColumn("available", std::vector<Teng::IntType_t>(count, 1));
+}
+
+/** Appends the same rows as fill_flat_rows() from columns.
+ */
+void fill_columns(Teng::FragmentList_t &rows, std::size_t count) {
+    Teng::FragmentColumns_t columns;
+    fill_columns(columns, count);
+    rows.addFragments(std::move(columns));
+}
+
+/** Builds JSON document equivalent to make_rows(count).
+ */
+std::string make_json(std::size_t count) {
+    std::string json = R"({"title": "Products", "row": [)";
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i) json.push_back(',');
+        json += R"({"id": )" + std::to_string(i) + ", "
+                R"("name": "product name", )"
+                R"("description": "some longer product description", )"
+                R"("price": 1999, )"
+                R"("url": "https://example.com/product", )"
+                R"("available": 1, )"
+                R"("tag": [{"name": "new"}]})";
+    }
+    json += "]}";
+    return json;
+}
+
+/** Data tree with the same rows as make_rows() whose fragments store the
+ * attributes in given map type. The storage of Fragment_t items is chosen at
+ * configure time, so this source compares std::map and FlatMap_t in one
+ * binary.
+ */
+template <template <typename...> class Map_t>
+class MapTree_t: public Teng::DataSource_t {
+public:
+    struct Node_t;
+
+    /** The attribute of fragment, scalar value or list of fragments.
+     */
+    struct Attr_t {
+        // move only, as FragmentValue_t
+        Attr_t() = default;
+        Attr_t(Attr_t &&) = default;
+        Attr_t &operator=(Attr_t &&) = default;
+
+        Teng::IntType_t integral = 0; //!< the integral value
+        std::string string;           //!< the string value
+        std::vector<Node_t> list;     //!< the nested fragments
+        enum {integral_tag, string_tag, list_tag} tag = integral_tag;
+    };
+
+    /** The fragment.
+     */
+    struct Node_t {
+        using Alloc_t = std::allocator<std::pair<const std::string, Attr_t>>;
+        Map_t<std::string, Attr_t, Teng::StrCmp_t, Alloc_t> attrs;
+
+        void add(const std::string &name, Teng::IntType_t value) {
+            Attr_t attr;
+            attr.integral = value;
+            attrs.emplace(name, std::move(attr));
+        }
+
+        void add(const std::string &name, std::string value) {
+            Attr_t attr;
+            attr.string = std::move(value);
+            attr.tag = Attr_t::string_tag;
+            attrs.emplace(name, std::move(attr));
+        }
+
+        void add(const std::string &name, std::vector<Node_t> list) {
+            Attr_t attr;
+            attr.list = std::move(list);
+            attr.tag = Attr_t::list_tag;
+            attrs.emplace(name, std::move(attr));
+        }
+    };
+
+    /** C'tor: builds tree with given number of rows.
+     */
+    explicit MapTree_t(std::size_t count) {
+        std::vector<Node_t> rows(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto &row = rows[i];
+            row.add("id", static_cast<Teng::IntType_t>(i));
+            row.add("name", "product name");
+            row.add("description", "some longer product description");
+            row.add("price", 1999);
+            row.add("url", "https://example.com/product");
+            row.add("available", 1);
+            std::vector<Node_t> tags(1);
+            tags.back().add("name", "new");
+            row.add("tag", std::move(tags));
+        }
+        top.add("title", "Products");
+        top.add("row", std::move(rows));
+    }
+
+    Teng::Value_t root() const override {return frag(&top);}
+
+    Teng::Value_t
+    attr(const Teng::DataNode_t &node, const Teng::string_view_t &name)
+    const override {
+        auto &attrs = static_cast<const Node_t *>(node.ptr)->attrs;
+        auto iattr = attrs.find(name);
+        return iattr == attrs.end()? Teng::Value_t(): value(iattr->second);
+    }
+
+    std::size_t size(const Teng::DataNode_t &list) const override {
+        return static_cast<const std::vector<Node_t> *>(list.ptr)->size();
+    }
+
+    Teng::Value_t
+    item(const Teng::DataNode_t &list, std::size_t i) const override {
+        return frag(&(*static_cast<const std::vector<Node_t> *>(list.ptr))[i]);
+    }
+
+    void
+    visit(const Teng::DataNode_t &node, const Visitor_t &visitor)
+    const override {
+        for (auto &attr: static_cast<const Node_t *>(node.ptr)->attrs)
+            visitor(attr.first, value(attr.second));
+    }
+
+private:
+    /** Converts the attribute to value.
+     */
+    Teng::Value_t value(const Attr_t &attr) const {
+        switch (attr.tag) {
+        case Attr_t::integral_tag: return Teng::Value_t(attr.integral);
+        case Attr_t::string_tag:
+            return Teng::Value_t(Teng::string_view_t(attr.string));
+        case Attr_t::list_tag: return list(&attr.list);
+        }
+        return Teng::Value_t();
+    }
+
+    Node_t top; //!< the root fragment
+};
+
+} // namespace
+
+TEST_CASE(
+    "Benchmark of building and rendering data tree",
+    "[benchmark][fragment]"
+) {
+    auto t = "<h1>${title}</h1>"
+             "<?teng frag row?>"
+             "<a href='${url}?id=${id}'>${name}</a> ${description}"
+             "<?teng if available?>${price}<?teng endif?>"
+             "<?teng frag tag?>[${name}]<?teng endfrag?>"
+             "<?teng endfrag?>";
+
+    REQUIRE(g(t, make_rows(1)) == (
+        "<h1>Products</h1>"
+        "<a href='https://example.com/product?id=0'>product name</a> "
+        "some longer product description1999[new]"
+    ));
+
+    for (std::size_t count: {100, 10000, 100000}) {
+        auto rows = make_rows(count);
+
+        BENCHMARK("build " + std::to_string(count) + " rows") {
+            return make_rows(count);
+        };
+
+        BENCHMARK("build " + std::to_string(count) + " rows in arena") {
+            Teng::DataArena_t arena;
+            Teng::Fragment_t root(arena);
+            fill_rows(root, count);
+            return root.size();
+        };
+
+        BENCHMARK("render " + std::to_string(count) + " rows") {
+            return g(t, rows);
+        };
+    }
+}
+
+TEST_CASE(
+    "Benchmark of rendering JSON document",
+    "[benchmark][fragment][json]"
+) {
+    auto t = "<h1>${title}</h1>"
+             "<?teng frag row?>"
+             "<a href='${url}?id=${id}'>${name}</a> ${description}"
+             "<?teng if available?>${price}<?teng endif?>"
+             "<?teng frag tag?>[${name}]<?teng endfrag?>"
+             "<?teng endfrag?>";
+
+    REQUIRE(g(t, Teng::JsonDocument_t(make_json(3)))
+            == g(t, make_rows(3)));
+
+    for (std::size_t count: {100, 10000, 100000}) {
+        auto json = make_json(count);
+
+        BENCHMARK("build and render " + std::to_string(count) + " rows") {
+            return g(t, make_rows(count));
+        };
+
+        BENCHMARK("parse and render " + std::to_string(count) + " rows") {
+            return g(t, Teng::JsonDocument_t(json));
+        };
+    }
+}
+
+TEST_CASE(
+    "Benchmark of rendering binary image of data tree",
+    "[benchmark][fragment][image]"
+) {
+    auto t = "<h1>${title}</h1>"
+             "<?teng frag row?>"
+             "<a href='${url}?id=${id}'>${name}</a> ${description}"
+             "<?teng if available?>${price}<?teng endif?>"
+             "<?teng frag tag?>[${name}]<?teng endfrag?>"
+             "<?teng endfrag?>";
+
+    auto image = Teng::FragmentImage_t::fromString(
+        Teng::makeFragmentImage(make_rows(3))
+    );
+    REQUIRE(g(t, image) == g(t, make_rows(3)));
+
+    for (std::size_t count: {100, 10000, 100000}) {
+        auto rows = make_rows(count);
+        auto image = Teng::FragmentImage_t::fromString(
+            Teng::makeFragmentImage(rows)
+        );
+
+        BENCHMARK("render " + std::to_string(count) + " rows from tree") {
+            return g(t, rows);
+        };
+
+        BENCHMARK("render " + std::to_string(count) + " rows from image") {
+            return g(t, image);
+        };
+    }
+}
+
+TEST_CASE(
+    "Benchmark of bulk building data tree",
+    "[benchmark][fragment]"
+) {
+    auto t = "<?teng frag row?>"
+             "<a href='${url}?id=${id}'>${name}</a> ${description}"
+             "<?teng if available?>${price}<?teng endif?>"
+             "<?teng endfrag?>";
+
+    Teng::Fragment_t by_rows;
+    fill_flat_rows(by_rows.addFragmentList("row"), 3);
+    Teng::Fragment_t by_columns;
+    fill_columns(by_columns.addFragmentList("row"), 3);
+    REQUIRE(g(t, by_rows) == g(t, by_columns));
+
+    Teng::FragmentColumns_t columnar_rows;
+    fill_columns(columnar_rows, 3);
+    Teng::Fragment_t columnar;
+    columnar.addValue("row", Teng::FragmentList_t(std::move(columnar_rows)));
+    REQUIRE(g(t, by_rows) == g(t, columnar));
+
+    for (std::size_t count: {100, 10000, 100000}) {
+        Teng::Fragment_t rows;
+        fill_flat_rows(rows.addFragmentList("row"), count);
+        Teng::FragmentColumns_t columns;
+        fill_columns(columns, count);
+        Teng::Fragment_t table;
+        table.addValue("row", Teng::FragmentList_t(std::move(columns)));
+
+        BENCHMARK("build " + std::to_string(count) + " rows one by one") {
+            Teng::Fragment_t root;
+            fill_flat_rows(root.addFragmentList("row"), count);
+            return root.size();
+        };
+
+        BENCHMARK("build " + std::to_string(count) + " rows by columns") {
+            Teng::Fragment_t root;
+            fill_columns(root.addFragmentList("row"), count);
+            return root.size();
+        };
+
+        BENCHMARK("build " + std::to_string(count) + " columnar rows") {
+            Teng::FragmentColumns_t columns;
+            fill_columns(columns, count);
+            Teng::Fragment_t root;
+            root.addValue("row", Teng::FragmentList_t(std::move(columns)));
+            return root.size();
+        };
+
+        BENCHMARK("render " + std::to_string(count) + " rows") {
+            return g(t, rows);
+        };
+
+        BENCHMARK("render " + std::to_string(count) + " columnar rows") {
+            return g(t, table);
+        };
+    }
+}
+
+TEST_CASE(
+    "Benchmark of storages of fragment items",
+    "[benchmark][fragment][storage]"
+) {
+    auto t = "<h1>${title}</h1>"
+             "<?teng frag row?>"
+             "<a href='${url}?id=${id}'>${name}</a> ${description}"
+             "<?teng if available?>${price}<?teng endif?>"
+             "<?teng frag tag?>[${name}]<?teng endfrag?>"
+             "<?teng endfrag?>";
+
+    using Tree_t = MapTree_t<std::map>;
+    using FlatTree_t = MapTree_t<Teng::FlatMap_t>;
+    REQUIRE(g(t, Tree_t(3)) == g(t, make_rows(3)));
+    REQUIRE(g(t, FlatTree_t(3)) == g(t, make_rows(3)));
+
+    for (std::size_t count: {100, 10000, 100000}) {
+        Tree_t tree(count);
+        FlatTree_t flat_tree(count);
+
+        BENCHMARK("build " + std::to_string(count) + " rows in std::map") {
+            return Tree_t(count);
+        };
+
+        BENCHMARK("build " + std::to_string(count) + " rows in flat map") {
+            return FlatTree_t(count);
+        };
+
+        BENCHMARK("render " + std::to_string(count) + " rows from std::map") {
+            return g(t, tree);
+        };
+
+        BENCHMARK("render " + std::to_string(count) + " rows from flat map") {
+            return g(t, flat_tree);
+        };
+    }
+}
@@ -446,3 +446,119 @@ SCENARIO(
     }
 }
 
+
+SCENARIO(
+    "Escaping of string literals in content type blocks",
+    "[ctype]"
+) {
+    GIVEN("Template with literals in nested content type blocks") {
+        auto t = "${'<&>'}<?teng ctype 'application/x-sh'?>${'<&>'}"
+                 "<?teng ctype 'quoted-string'?>${'\"'}<?teng endctype?>"
+                 "<?teng endctype?>${'<&>'}";
+
+        WHEN("Generated") {
+            Teng::Error_t err;
+            auto result = g(err, t);
+
+            THEN("Literals are escaped by escaper of their content type") {
+                std::vector<Teng::Error_t::Entry_t> errs;
+                ERRLOG_TEST(err.getEntries(), errs);
+                REQUIRE(result == "&lt;&amp;&gt;<&>\\\"&lt;&amp;&gt;");
+            }
+        }
+    }
+
+    GIVEN("Template with dictionary item") {
+        auto t = "#{html_small}<?teng ctype 'application/x-sh'?>#{html_small}"
+                 "<?teng endctype?>";
+
+        WHEN("Generated") {
+            Teng::Error_t err;
+            auto result = g(err, t);
+
+            THEN("Dictionary item is escaped by escaper of its content type") {
+                std::vector<Teng::Error_t::Entry_t> errs;
+                ERRLOG_TEST(err.getEntries(), errs);
+                REQUIRE(result == "&amp;&lt;b&gt;&<b>");
+            }
+        }
+    }
+
+    GIVEN("Template with literal and bytecode fragment") {
+        auto t = "${'<'}<?teng bytecode?>";
+
+        WHEN("Generated with bytecode fragment enabled") {
+            Teng::Error_t err;
+            auto result = g(err, t, {}, "teng.debug.conf");
+
+            THEN("The literal is escaped in compile time") {
+                std::vector<Teng::Error_t::Entry_t> errs;
+                ERRLOG_TEST(err.getEntries(), errs);
+                REQUIRE(
+                    result
+                    == "&lt;"
+                       "000 VAL                 "
+                       "&lt;value=&amp;lt;,type=string&gt;\n"
+                       "001 PRINT_RAW           \n"
+                       "002 BYTECODE_FRAG       \n"
+                       "003 HALT                \n"
+                );
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Prints specialized for content type in compile time",
+    "[ctype]"
+) {
+    GIVEN("Variable printed in various content types") {
+        Teng::Fragment_t root;
+        root.addVariable("a", "<'>");
+        auto t = "${a}"
+                 "<?teng ctype 'application/x-javascript'?>"
+                 "${a}"
+                 "<?teng endctype?>"
+                 "<?teng ctype 'quoted-string'?>${a}<?teng endctype?>"
+                 "%{a}"
+                 "<?teng ctype 'text/plain'?>"
+                 "<?teng bytecode?>"
+                 "<?teng endctype?>";
+
+        WHEN("Generated with bytecode fragment enabled") {
+            Teng::Error_t err;
+            auto result = g(err, t, root, "teng.debug.conf");
+
+            THEN("Each print uses escaping of its content type") {
+                std::vector<Teng::Error_t::Entry_t> errs;
+                ERRLOG_TEST(err.getEntries(), errs);
+                REQUIRE(
+                    result
+                    == "&lt;'&gt;<\\'>" "<\\'><'>"
+                       "000 VAR                 "
+                       "<name=a,escape=true,frame-offset=0,frag-offset=0>\n"
+                       "001 PRINT_ESC_HTML      \n"
+                       "002 OPEN_CTYPE          "
+                       "<mime-type=application/x-javascript>\n"
+                       "003 VAR                 "
+                       "<name=a,escape=true,frame-offset=0,frag-offset=0>\n"
+                       "004 PRINT_ESC_JS        \n"
+                       "005 CLOSE_CTYPE         \n"
+                       "006 OPEN_CTYPE          <mime-type=quoted-string>\n"
+                       "007 VAR                 "
+                       "<name=a,escape=true,frame-offset=0,frag-offset=0>\n"
+                       "008 PRINT_ESC           "
+                       "<mime-type=quoted-string>\n"
+                       "009 CLOSE_CTYPE         \n"
+                       "010 VAR                 "
+                       "<name=a,escape=false,frame-offset=0,frag-offset=0>\n"
+                       "011 PRINT_RAW           \n"
+                       "012 OPEN_CTYPE          <mime-type=text/plain>\n"
+                       "013 BYTECODE_FRAG       \n"
+                       "014 CLOSE_CTYPE         \n"
+                       "015 HALT                \n"
+                );
+            }
+        }
+    }
+}
@@ -0,0 +1,177 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- tests of the abstract data source.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <string>
+#include <vector>
+#include <teng/teng.h>
+#include <teng/datasource.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "utils.h"
+
+namespace {
+
+/** The application structure exposed by data source.
+ */
+struct User_t {
+    std::string name;
+    int karma;
+};
+
+/** Data source that exposes list of users and counts the attribute reads.
+ * The root fragment is node without ptr, the users are nodes pointing to the
+ * list with the user index as id.
+ */
+class Users_t: public Teng::DataSource_t {
+public:
+    Users_t(std::vector<User_t> users): users(std::move(users)) {}
+
+    Teng::Value_t root() const override {return frag(nullptr);}
+
+    Teng::Value_t
+    attr(const Teng::DataNode_t &node, const Teng::string_view_t &name)
+    const override {
+        reads.push_back(name.str());
+        if (!node.ptr) {
+            if (name == "title") return Teng::Value_t(title);
+            if (name == "user") return list(&users);
+            return Teng::Value_t();
+        }
+        auto &user = users[node.id];
+        if (name == "name") return Teng::Value_t(user.name);
+        if (name == "karma") return Teng::Value_t(user.karma);
+        return Teng::Value_t();
+    }
+
+    std::size_t size(const Teng::DataNode_t &) const override {
+        return users.size();
+    }
+
+    Teng::Value_t
+    item(const Teng::DataNode_t &, std::size_t i) const override {
+        return frag(&users, i);
+    }
+
+    void
+    visit(const Teng::DataNode_t &node, const Visitor_t &visitor)
+    const override {
+        if (!node.ptr) {
+            visitor("title", Teng::Value_t(title));
+            visitor("user", list(&users));
+            return;
+        }
+        visitor("karma", Teng::Value_t(users[node.id].karma));
+        visitor("name", Teng::Value_t(users[node.id].name));
+    }
+
+    Teng::Fragment_t fragment() const {
+        Teng::Fragment_t result;
+        result.addVariable("title", title.str());
+        for (auto &user: users) {
+            auto &frag = result.addFragment("user");
+            frag.addVariable("karma", user.karma);
+            frag.addVariable("name", user.name);
+        }
+        return result;
+    }
+
+    Teng::string_view_t title = "users";
+    std::vector<User_t> users;
+    mutable std::vector<std::string> reads;
+};
+
+} // namespace
+
+SCENARIO(
+    "Rendering data from custom data source",
+    "[datasource]"
+) {
+    GIVEN("Data source exposing list of users") {
+        Users_t users({{"john", 3}, {"jane", 5}});
+
+        WHEN("The lists and values are rendered") {
+            auto t = "${title}:<?teng frag user?>${name}=${karma}"
+                     "[${_index}/${_count}]<?teng endfrag?>";
+            auto result = g(t, users);
+
+            THEN("It is same as for equivalent fragment") {
+                REQUIRE(result == "users:john=3[0/2]jane=5[1/2]");
+                REQUIRE(result == g(t, users.fragment()));
+            }
+        }
+
+        WHEN("The path expressions and queries are evaluated") {
+            Teng::Error_t err;
+            auto t = "${$$user[1].name} ${count($$user)} ${$$user.name} "
+                     "${isempty($$user[0])} ${type($$user[0])} "
+                     "%{jsonify($$user[0])}";
+            auto result = g(err, t, users);
+
+            THEN("They are same as for equivalent fragment") {
+                Teng::Error_t frag_err;
+                REQUIRE(result == "jane 2 undefined 0 frag_ref "
+                                  "{\"karma\": 3, \"name\": \"john\"}");
+                REQUIRE(result == g(frag_err, t, users.fragment()));
+                REQUIRE(err.getEntries().size()
+                        == frag_err.getEntries().size());
+            }
+        }
+
+        WHEN("The template reads only some values") {
+            auto t = "<?teng if 0?>${title}<?teng endif?>"
+                     "${$$user[0].name}";
+            auto result = g(t, users);
+
+            THEN("Only the read values are asked for") {
+                REQUIRE(result == "john");
+                std::vector<std::string> reads = {"user", "name"};
+                REQUIRE(users.reads == reads);
+            }
+        }
+
+        WHEN("The debug fragment is rendered") {
+            Teng::Error_t err;
+            auto t = "<?teng debug?>";
+            auto result = g(err, t, users, "teng.debug.conf");
+            Teng::Error_t frag_err;
+            auto expected = g(frag_err, t, users.fragment(), "teng.debug.conf");
+
+            THEN("It contains the data of source") {
+                REQUIRE(result == expected);
+            }
+        }
+    }
+}
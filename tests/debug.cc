@@ -34,7 +34,11 @@
  *             Created.
  */
 
+#include <map>
+#include <sstream>
+
 #include <teng/teng.h>
+#include <teng/profile.h>
 
 #include "catch2/catch_test_macros.hpp"
 #include "utils.h"
@@ -79,6 +83,8 @@ SCENARIO(
                      "    alwaysescape: enabled\n"
                      "    printescape: enabled\n"
                      "    shorttag: enabled\n"
+                     "    compilereport: disabled\n"
+                     "    execprofile: disabled\n"
                      "\n"
                      "Application data:\n"
                      "    pi: 3.140000\n"
@@ -150,7 +156,7 @@ SCENARIO(
                      "017 JMP                 &lt;jump=+1&gt;\n"
                      "018 VAL                 &lt;value=c,type=string&gt;\n"
                      "019 PRG_STACK_POP       \n"
-                     "020 PRINT               &lt;print_escape=true,unoptimizable=false&gt;\n"
+                     "020 PRINT_ESC_HTML      \n"
                      "021 BYTECODE_FRAG       \n"
                      "022 HALT                \n";
 
@@ -259,3 +265,175 @@ SCENARIO(
     }
 }
 
+
+SCENARIO(
+    "Profiling the template",
+    "[debug]"
+) {
+    GIVEN("Template with fragments and overridden block") {
+        Teng::Teng_t teng(TEST_ROOT);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.templateString
+            = "<?teng extends file='base.html'?>"
+              "<?teng override block body?>\n"
+              "<?teng frag a?>${b}\n"
+              "<?teng frag c?>${d}<?teng endfrag?>"
+              "<?teng endfrag?>"
+              "<?teng endoverride block?>"
+              "<?teng endextends?>";
+        Teng::Fragment_t root;
+        for (auto i = 0; i < 3; ++i) {
+            auto &a = root.addFragment("a");
+            a.addVariable("b", i);
+            a.addFragment("c").addVariable("d", i);
+        }
+
+        WHEN("The page is generated with profile") {
+            Teng::Profile_t profile;
+            args.profile = &profile;
+            Teng::Error_t err;
+            std::string result;
+            Teng::StringWriter_t writer(result);
+            teng.generatePage(args, root, writer, err);
+
+            THEN("Instructions are attributed to fragments and blocks") {
+                REQUIRE(err.empty());
+                std::map<std::string, uint64_t> stacks;
+                for (auto &entry: profile.entries())
+                    stacks[entry.stack] += entry.instructions;
+                REQUIRE(stacks.count("root"));
+                REQUIRE(stacks.count("root;block body"));
+                REQUIRE(stacks.count("root;a;block body"));
+                REQUIRE(stacks.count("root;a;c;block body"));
+                REQUIRE(stacks["root;a;c;block body"] >= 3);
+            }
+
+            THEN("The collapsed stacks contain lines of template") {
+                std::ostringstream os;
+                profile.collapsed(os, Teng::Profile_t::Metric_t::INSTRUCTIONS);
+                auto collapsed = os.str();
+                auto npos = std::string::npos;
+                REQUIRE(collapsed.find("root;a;c;block body;") != npos);
+                REQUIRE(collapsed.find("base.html:1 ") != npos);
+            }
+        }
+
+        WHEN("The page is generated without profile") {
+            Teng::Profile_t profile;
+            Teng::Error_t err;
+            std::string result;
+            Teng::StringWriter_t writer(result);
+            teng.generatePage(args, root, writer, err);
+
+            THEN("Nothing is profiled") {
+                REQUIRE(profile.empty());
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "The compile report",
+    "[debug]"
+) {
+    GIVEN("Template with foldable expression and bytecode fragment") {
+        Teng::Teng_t teng(TEST_ROOT);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.templateString = "${1 + 2}<?teng frag a?>${b}<?teng endfrag?>"
+                              "<?teng bytecode?>";
+        args.dictFilename = TEST_ROOT "dict.txt";
+
+        WHEN("The compile report is enabled and the template is rendered") {
+            args.paramsFilename = TEST_ROOT "teng.compilereport.conf";
+            Teng::Error_t err;
+            std::string result;
+            Teng::StringWriter_t writer(result);
+            Teng::Fragment_t root;
+            teng.generatePage(args, root, writer, err);
+            auto stats = teng.cacheStats();
+            auto report = teng.compileReport(args);
+
+            THEN("It contains the counters of compilation") {
+                REQUIRE(err.empty());
+                REQUIRE(report.totalTime > 0);
+                REQUIRE(report.lex1Tokens > 0);
+                REQUIRE(report.lex2Tokens > 0);
+                REQUIRE(report.evalAttempts > 0);
+                REQUIRE(report.evalSuccesses > 0);
+                REQUIRE(report.instructions > 0);
+                REQUIRE(report.files == 0);
+            }
+
+            THEN("The total time is the compile time of the program") {
+                REQUIRE(report.totalTime == stats.programs.loadTime);
+            }
+
+            THEN("Reading it doesn't touch the cache counters") {
+                auto after = teng.cacheStats();
+                REQUIRE(after.programs.hits == stats.programs.hits);
+                REQUIRE(after.programs.misses == stats.programs.misses);
+                REQUIRE(after.programs.loads == stats.programs.loads);
+            }
+
+            THEN("It is printed by the bytecode fragment") {
+                auto npos = std::string::npos;
+                REQUIRE(result.find("Compile report:") != npos);
+            }
+        }
+
+        WHEN("The compile report is enabled but nothing is rendered") {
+            args.paramsFilename = TEST_ROOT "teng.compilereport.conf";
+            auto report = teng.compileReport(args);
+
+            THEN("The report is empty and nothing is compiled") {
+                REQUIRE(report.totalTime == 0);
+                REQUIRE(teng.cacheStats().programs.loads == 0);
+            }
+        }
+
+        WHEN("The compile report is disabled") {
+            args.paramsFilename = TEST_ROOT "teng.conf";
+            Teng::Error_t err;
+            std::string result;
+            Teng::StringWriter_t writer(result);
+            Teng::Fragment_t root;
+            teng.generatePage(args, root, writer, err);
+            auto report = teng.compileReport(args);
+
+            THEN("The report is empty") {
+                REQUIRE(err.empty());
+                REQUIRE(report.totalTime == 0);
+                REQUIRE(report.instructions == 0);
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "The execution counters",
+    "[debug]"
+) {
+    GIVEN("Template with fragment and bytecode fragment") {
+        Teng::Teng_t teng(TEST_ROOT);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.templateString = "<?teng frag a?>${b}<?teng endfrag?>"
+                              "<?teng bytecode?>";
+        args.paramsFilename = TEST_ROOT "teng.execprofile.conf";
+        Teng::Fragment_t root;
+        for (auto i = 0; i < 3; ++i)
+            root.addFragment("a").addVariable("b", i);
+
+        WHEN("The template is rendered twice") {
+            auto first = g(teng, args, root);
+            auto second = g(teng, args, root);
+
+            THEN("The bytecode contains counters of previous renders") {
+                auto npos = std::string::npos;
+                REQUIRE(first.find("[0x ") != npos);
+                REQUIRE(first.find("[3x ") == npos);
+                REQUIRE(second.find("] VAR") != npos);
+                REQUIRE(second.find("[3x ") != npos);
+            }
+        }
+    }
+}
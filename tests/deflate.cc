@@ -0,0 +1,208 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- tests of the deflate writer.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <zlib.h>
+#include <string>
+#include <memory>
+#include <teng/teng.h>
+#include <teng/deflatewriter.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "utils.h"
+
+namespace {
+
+/** Decompresses gzip data, the stream does not have to be terminated.
+ */
+std::string inflate_gzip(const std::string &data) {
+    z_stream zs{};
+    inflateInit2(&zs, 16 + MAX_WBITS);
+    zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+
+    std::string result;
+    char buffer[4096];
+    int res = Z_OK;
+    do {
+        zs.next_out = reinterpret_cast<Bytef *>(buffer);
+        zs.avail_out = sizeof(buffer);
+        res = inflate(&zs, Z_SYNC_FLUSH);
+        result.append(buffer, sizeof(buffer) - zs.avail_out);
+    } while ((res == Z_OK) && zs.avail_in);
+    inflateEnd(&zs);
+    return res == Z_DATA_ERROR? "<data error>": result;
+}
+
+/** Generates gzipped page.
+ */
+std::string gz(
+    const std::string &templ,
+    const Teng::Fragment_t &data,
+    std::shared_ptr<Teng::DeflateCache_t> cache = {}
+) {
+    std::string result;
+    Teng::StringWriter_t output(result);
+    Teng::DeflateWriter_t writer(
+        output,
+        Teng::DeflateWriter_t::FORMAT_GZIP,
+        -1,
+        std::move(cache)
+    );
+    Teng::Error_t err;
+    Teng::Teng_t teng(TEST_ROOT);
+    Teng::Teng_t::GenPageArgs_t args;
+    args.templateString = templ;
+    teng.generatePage(args, data, writer, err);
+    writer.finish();
+    return result;
+}
+
+} // namespace
+
+SCENARIO(
+    "Compressing the page by deflate writer",
+    "[deflate]"
+) {
+    GIVEN("Template with some variables and fragments") {
+        Teng::Fragment_t root;
+        for (auto i = 0; i < 100; ++i)
+            root.addFragment("a").addVariable("b", "<b>" + std::to_string(i));
+        auto t = "<?teng frag a?>${b},<?teng endfrag?>";
+
+        WHEN("The page is generated into deflate writer") {
+            auto result = gz(t, root);
+
+            THEN("The decompressed page is the same as uncompressed one") {
+                REQUIRE(result.size() < g(t, root).size());
+                REQUIRE(inflate_gzip(result) == g(t, root));
+            }
+        }
+    }
+
+    GIVEN("Deflate writer") {
+        std::string result;
+        Teng::StringWriter_t output(result);
+        Teng::DeflateWriter_t writer(output);
+
+        WHEN("Some data are written and flushed") {
+            writer.write("some data, ");
+            writer.flush();
+            auto flushed = result;
+            writer.write("other data");
+
+            THEN("The flushed data can be decompressed") {
+                REQUIRE(inflate_gzip(flushed) == "some data, ");
+            }
+
+            THEN("The finished stream contains all data") {
+                writer.finish();
+                REQUIRE(inflate_gzip(result) == "some data, other data");
+                REQUIRE(writer.write("more data") != 0);
+            }
+        }
+    }
+
+    GIVEN("Flushed deflate writer that is not finished") {
+        std::string result;
+        Teng::StringWriter_t output(result);
+        auto writer = std::make_unique<Teng::DeflateWriter_t>(output);
+        writer->write("some data");
+        writer->flush();
+        auto flushed = result;
+
+        WHEN("The writer is destroyed") {
+            writer.reset();
+
+            THEN("Nothing is written to the underlying writer") {
+                REQUIRE(result == flushed);
+            }
+        }
+    }
+
+    GIVEN("Template with long literal and cache of compressed literals") {
+        Teng::Fragment_t root;
+        root.addVariable("a", "<a>");
+        std::string literal(2000, 'x');
+        auto t = "${a}" + literal + "${a}" + literal + "${a}";
+        auto cache = std::make_shared<Teng::DeflateCache_t>(1000);
+
+        WHEN("The page is generated twice") {
+            auto first = gz(t, root, cache);
+            auto second = gz(t, root, cache);
+
+            THEN("The literal is compressed only once") {
+                REQUIRE(cache->size() == 1);
+                REQUIRE(first == second);
+                REQUIRE(inflate_gzip(first) == g(t, root));
+            }
+        }
+    }
+
+    GIVEN("Template with long variable and cache of compressed literals") {
+        Teng::Fragment_t root;
+        root.addVariable("a", std::string(2000, 'x'));
+        auto t = "<a>${a}</a>";
+        auto cache = std::make_shared<Teng::DeflateCache_t>(1000);
+
+        WHEN("The page is generated") {
+            auto result = gz(t, root, cache);
+
+            THEN("The value of variable is not cached") {
+                REQUIRE(cache->size() == 0);
+                REQUIRE(result == gz(t, root));
+                REQUIRE(inflate_gzip(result) == g(t, root));
+            }
+        }
+    }
+
+    GIVEN("Template with long literal and full cache of compressed literals") {
+        Teng::Fragment_t root;
+        root.addVariable("a", "<a>");
+        std::string literal(2000, 'x');
+        auto t = "${a}" + literal + "${a}";
+        auto cache = std::make_shared<Teng::DeflateCache_t>(1000, 1000);
+
+        WHEN("The page is generated") {
+            auto result = gz(t, root, cache);
+
+            THEN("The literal is compressed as a part of the stream") {
+                REQUIRE(cache->size() == 0);
+                REQUIRE(result == gz(t, root));
+                REQUIRE(inflate_gzip(result) == g(t, root));
+            }
+        }
+    }
+}
@@ -40,6 +40,7 @@
 #include "utils.h"
 
 #include <sstream>
+#include <utility>
 
 SCENARIO(
     "Zero Teng fragments",
@@ -724,6 +725,292 @@ SCENARIO(
     }
 }
 
+SCENARIO(
+    "Fragments allocated from data arena",
+    "[frags]"
+) {
+    GIVEN("Data tree built in arena") {
+        Teng::DataArena_t arena;
+        Teng::Fragment_t root(arena);
+        root.addVariable("title", "list");
+        for (auto i = 0; i < 3; ++i) {
+            auto &row = root.addFragment("row");
+            row.addVariable("id", i);
+            row.addFragmentList("tags").addFragment().addVariable("n", "t");
+        }
+
+        THEN("Nested fragments and lists are allocated from arena") {
+            auto &rows = *std::as_const(root).find("row")->second.list();
+            REQUIRE(rows.resource() == arena.resource());
+            REQUIRE(rows[1].fragment()->resource() == arena.resource());
+        }
+
+        WHEN("The tree is rendered") {
+            auto t = "${title}:<?teng frag row?>${id}"
+                     "<?teng frag tags?>${n}<?teng endfrag?>"
+                     "<?teng endfrag?>";
+            auto result = g(t, root);
+
+            THEN("It is same as tree allocated on heap") {
+                REQUIRE(result == "list:0t1t2t");
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Keys of fragment items",
+    "[frags]"
+) {
+    GIVEN("Two fragments with same variable names") {
+        Teng::Fragment_t root;
+        root.addFragment("row").addVariable("name", "first");
+        root.addFragment("row").addVariable("name", "second");
+
+        THEN("The keys are plain strings") {
+            auto &rows = *root.get("row")->list();
+            const std::string &lhs = rows[0].fragment()->begin()->first;
+            const std::string &rhs = rows[1].fragment()->begin()->first;
+            REQUIRE(lhs == "name");
+            REQUIRE(rhs == "name");
+        }
+
+        WHEN("The variables and local variables are rendered") {
+            auto t = "<?teng frag row?>"
+                     "<?teng set tmp = name?>${tmp}:${name},"
+                     "<?teng endfrag?>";
+            auto result = g(t, root);
+
+            THEN("The values are found by names") {
+                REQUIRE(result == "first:first,second:second,");
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Shared immutable fragments mounted to data trees",
+    "[frags]"
+) {
+    GIVEN("Shared navigation fragment mounted to two data trees") {
+        Teng::Fragment_t nav_data;
+        nav_data.addFragment("item").addVariable("title", "home");
+        nav_data.addFragment("item").addVariable("title", "about");
+        auto nav = std::make_shared<const Teng::Fragment_t>(
+            std::move(nav_data)
+        );
+
+        Teng::Fragment_t first;
+        first.addVariable("page", "first");
+        first.addSharedFragment("nav", nav);
+        Teng::Fragment_t second;
+        second.addVariable("page", "second");
+        second.addFragmentList("navs").addSharedFragment(nav);
+
+        THEN("The fragment is referenced, not copied") {
+            REQUIRE(nav.use_count() == 3);
+            REQUIRE(std::as_const(first).find("nav")->second.fragment()
+                    == nav.get());
+        }
+
+        WHEN("Both trees are rendered") {
+            auto t = "${page}:<?teng frag nav?><?teng frag item?>"
+                     "${title},<?teng endfrag?><?teng endfrag?>"
+                     "<?teng frag navs?><?teng frag item?>"
+                     "${title},<?teng endfrag?><?teng endfrag?>";
+            auto first_result = g(t, first);
+            auto second_result = g(t, second);
+
+            THEN("Both see the shared data") {
+                REQUIRE(first_result == "first:home,about,");
+                REQUIRE(second_result == "second:home,about,");
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Building fragment list from columns",
+    "[frags]"
+) {
+    GIVEN("Columns of values of different types") {
+        Teng::FragmentColumns_t columns;
+        columns.addColumn("name", std::vector<std::string>{"a", "b"});
+        columns.addColumn("id", std::vector<Teng::IntType_t>{1, 2});
+        columns.addColumn("price", std::vector<double>{0.5, 1.5});
+
+        WHEN("The fragments are appended to list") {
+            Teng::Fragment_t root;
+            auto &list = root.addFragmentList("row");
+            list.addFragment().addVariable("name", "first");
+            list.addFragments(std::move(columns));
+            auto t = "<?teng frag row?>${id}:${name}:${price},<?teng endfrag?>";
+
+            THEN("There is one fragment per row") {
+                REQUIRE(list.size() == 3);
+                REQUIRE(g(t, root) == "undefined:first:undefined,"
+                                      "1:a:0.5,2:b:1.5,");
+            }
+        }
+
+        WHEN("The column of different size is added") {
+            auto add = [&] {
+                columns.addColumn("other", std::vector<double>{1.0});
+            };
+
+            THEN("It throws") {
+                REQUIRE_THROWS_AS(add(), std::runtime_error);
+            }
+        }
+
+        WHEN("The column of the same name is added") {
+            auto add = [&] {
+                columns.addColumn("id", std::vector<double>{1.0, 2.0});
+            };
+
+            THEN("It throws") {
+                REQUIRE_THROWS_AS(add(), std::runtime_error);
+            }
+        }
+    }
+
+    GIVEN("The string values moved to fragments") {
+        Teng::Fragment_t root;
+        std::string value(64, 'x');
+        auto *data = value.data();
+        root.addStringVariable("var", std::move(value));
+        std::string item(64, 'y');
+        auto *item_data = item.data();
+        root.addFragmentList("list").addStringValue(std::move(item));
+
+        THEN("The buffers are adopted") {
+            auto &frag = std::as_const(root);
+            REQUIRE(frag.find("var")->second.string()->data() == data);
+            REQUIRE(frag.find("list")->second.list()->begin()->string()->data()
+                    == item_data);
+        }
+    }
+}
+
+SCENARIO(
+    "Columnar fragment lists",
+    "[frags]"
+) {
+    GIVEN("Data with columnar fragment list") {
+        Teng::FragmentColumns_t columns;
+        columns.addColumn("name", std::vector<std::string>{"a", "b", "c"});
+        columns.addColumn("id", std::vector<Teng::IntType_t>{1, 2, 3});
+        Teng::Fragment_t root;
+        root.addVariable("title", "rows");
+        root.addValue("row", Teng::FragmentList_t(std::move(columns)));
+
+        WHEN("The rows are iterated") {
+            auto t = "<?teng frag row?>${_index}/${_count}:${id}=${name}"
+                     "<?teng if _first?>(first)<?teng endif?>"
+                     "<?teng if _last?>(last)<?teng endif?>"
+                     "[${title}],<?teng endfrag?>";
+            auto result = g(t, root);
+
+            THEN("The values are read from columns") {
+                REQUIRE(result == "0/3:1=a(first)[rows],"
+                                  "1/3:2=b[rows],"
+                                  "2/3:3=c(last)[rows],");
+            }
+        }
+
+        WHEN("The rows are accessed by runtime variable") {
+            auto t = "${$$row[1].name},${$$row[-1].id},${count($$row)}";
+            auto result = g(t, root);
+
+            THEN("The values are read from columns") {
+                REQUIRE(result == "b,3,3");
+            }
+        }
+
+        WHEN("The rows are inspected like fragments") {
+            Teng::Fragment_t frags;
+            frags.addVariable("title", "rows");
+            for (auto i = 1; i <= 3; ++i) {
+                auto &row = frags.addFragment("row");
+                row.addVariable("name", std::string(1, char('a' + i - 1)));
+                row.addVariable("id", i);
+            }
+            auto t = "${type($$row[1])},${count($$row[1])},${$$row.name},"
+                     "${jsonify($$row)}";
+            Teng::Error_t err;
+            auto result = g(err, t, root);
+            Teng::Error_t frags_err;
+            auto expected = g(frags_err, t, frags);
+
+            THEN("The row is fragment and the list is ambiguous") {
+                REQUIRE(result == expected);
+                REQUIRE(err.getEntries().size()
+                        == frags_err.getEntries().size());
+            }
+        }
+
+        WHEN("The columnar list is iterated in const context") {
+            auto &list = *std::as_const(root).find("row")->second.list();
+
+            THEN("The rows are built from columns") {
+                std::vector<std::string> names;
+                for (auto &item: list)
+                    names.push_back(*item.fragment()->get("name")->string());
+                REQUIRE(names == std::vector<std::string>{"a", "b", "c"});
+                REQUIRE(*list[2].fragment()->get("id")->integral() == 3);
+                REQUIRE(&list[0] == &*list.begin());
+                REQUIRE(list.columns() != nullptr);
+            }
+        }
+
+        WHEN("The unknown variable or nested fragment is used in row") {
+            auto t = "<?teng frag row?>${missing}"
+                     "<?teng frag nested?>x<?teng endfrag?>,<?teng endfrag?>";
+            auto result = g(t, root);
+
+            THEN("It behaves like missing variable in fragment") {
+                REQUIRE(result == "undefined,undefined,undefined,");
+            }
+        }
+
+        WHEN("The fragment is appended to list") {
+            auto &list = root.addFragmentList("row");
+            list.addFragment().addVariable("name", "d");
+            auto t = "<?teng frag row?>${name},<?teng endfrag?>";
+
+            THEN("The list is converted to list of fragments") {
+                REQUIRE(list.columns() == nullptr);
+                REQUIRE(list.size() == 4);
+                REQUIRE(g(t, root) == "a,b,c,d,");
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "References to fragment items",
+    "[frags]"
+) {
+    GIVEN("Fragment with nested fragment and fragment list") {
+        Teng::Fragment_t root;
+        auto &frag = root.addFragment("m");
+        root.addFragmentList("k");
+
+        WHEN("Many other items are added to fragment") {
+            for (auto i = 0; i < 1000; ++i)
+                root.addVariable("v" + std::to_string(i), i);
+            frag.addVariable("x", 1);
+            root.addFragmentList("k").addFragment().addVariable("y", 2);
+
+            THEN("The reference to nested fragment remains valid") {
+                auto t = "${m.x}<?teng frag k?>${y}<?teng endfrag?>${v999}";
+                REQUIRE(root.size() == 1002);
+                REQUIRE(g(t, root) == "12999");
+            }
+        }
+    }
+}
+
 SCENARIO(
     "Fuzzer problems in fragments",
     "[frags][fuzzer]"
@@ -167,6 +167,25 @@ SCENARIO(
             }
         }
     }
+
+    GIVEN("The json content type") {
+        Teng::Fragment_t root;
+        root.addVariable("s", R"(some\"text\/&\\x\y\)");
+        auto t = "<?teng ctype 'application/json'?>"
+                 "%{unescape($s)}"
+                 "<?teng endctype?>";
+
+        WHEN("The unescape is called") {
+            Teng::Error_t err;
+            auto result = g(err, t, root);
+
+            THEN("Escape sequences are unescaped, the others are kept") {
+                std::vector<Teng::Error_t::Entry_t> errs;
+                ERRLOG_TEST(err.getEntries(), errs);
+                REQUIRE(result == R"(some"text/&\x\y\)");
+            }
+        }
+    }
 }
 
 SCENARIO(
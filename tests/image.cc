@@ -0,0 +1,129 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- tests of the binary image of data tree.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <cstdio>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <teng/teng.h>
+#include <teng/fragmentimage.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "utils.h"
+
+SCENARIO(
+    "Rendering data from binary image of data tree",
+    "[image]"
+) {
+    GIVEN("Image of data tree with nested fragments and lists") {
+        Teng::Fragment_t root;
+        root.addVariable("title", "list");
+        root.addVariable("pi", 3.5);
+        for (auto i = 0; i < 3; ++i) {
+            auto &row = root.addFragment("row");
+            row.addVariable("id", i);
+            row.addFragment("tag").addVariable("name", "t" + std::to_string(i));
+        }
+        root.addFragmentList("nums").addValue(7);
+        auto image = Teng::makeFragmentImage(root);
+        auto t = "${title} ${pi} ${$$nums[0]}:<?teng frag row?>${id}"
+                 "<?teng frag tag?>[${name}]<?teng endfrag?>"
+                 "<?teng endfrag?>";
+
+        WHEN("The image is rendered from memory") {
+            auto view = Teng::FragmentImage_t::fromString(image);
+            auto result = g(t, view);
+
+            THEN("It is same as the original tree") {
+                REQUIRE(result == g(t, root));
+                REQUIRE(result == "list 3.5 7:0[t0]1[t1]2[t2]");
+            }
+        }
+
+        WHEN("The image is mapped from file") {
+            auto filename = "fragment-image-test.img";
+            std::ofstream(filename, std::ios::binary) << image;
+            auto view = Teng::FragmentImage_t(filename);
+            std::remove(filename);
+            auto result = g(t, view);
+
+            THEN("It is same as the original tree") {
+                REQUIRE(result == "list 3.5 7:0[t0]1[t1]2[t2]");
+            }
+        }
+
+        WHEN("The debug output of image is rendered") {
+            auto view = Teng::FragmentImage_t::fromString(image);
+            auto d = "<?teng debug?>";
+            Teng::Error_t err;
+            auto result = g(err, d, view, "teng.debug.conf");
+            Teng::Error_t root_err;
+            auto expected = g(root_err, d, root, "teng.debug.conf");
+
+            THEN("It is same as the debug output of original tree") {
+                REQUIRE(result == expected);
+            }
+        }
+
+        WHEN("The index entry of image refers back to its fragment") {
+            uint64_t nodes = 0;
+            std::memcpy(&nodes, image.data() + 16, sizeof(nodes));
+            auto index = 40 + nodes * 16;
+            std::memset(&image[index], 0, sizeof(uint32_t));
+            auto view = Teng::FragmentImage_t::fromString(image);
+
+            THEN("It is rejected when it is accessed") {
+                REQUIRE_THROWS_AS(
+                    view.attr(view.root().as_frag_ref(), "nums"),
+                    std::runtime_error
+                );
+            }
+        }
+
+        WHEN("The image is truncated") {
+            image.resize(image.size() - 1);
+
+            THEN("It is rejected") {
+                REQUIRE_THROWS_AS(
+                    Teng::FragmentImage_t::fromString(image),
+                    std::runtime_error
+                );
+            }
+        }
+    }
+}
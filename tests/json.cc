@@ -0,0 +1,125 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- tests of the JSON document data source.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <string>
+#include <stdexcept>
+#include <teng/teng.h>
+#include <teng/jsondocument.h>
+
+#include "catch2/catch_test_macros.hpp"
+#include "utils.h"
+
+SCENARIO(
+    "Rendering data from JSON document",
+    "[json]"
+) {
+    GIVEN("JSON document with nested objects and arrays") {
+        Teng::JsonDocument_t doc(R"({
+            "title": "A \"quoted\" é",
+            "count": 2,
+            "ratio": 0.5,
+            "flag": true,
+            "nothing": null,
+            "user": {"name": "john"},
+            "row": [{"id": 1}, {"id": 2, "tag": [{"name": "new"}]}],
+            "nums": [1, 2, 3]
+        })");
+
+        WHEN("The scalar values are rendered") {
+            auto t = "${title}|${count}|${ratio}|${flag}";
+            auto result = g(t, doc);
+
+            THEN("They have same types as fragment values") {
+                REQUIRE(result == "A &quot;quoted&quot; \xc3\xa9|2|0.5|1");
+            }
+        }
+
+        WHEN("The objects and arrays of objects are rendered") {
+            auto t = "${$$user.name}:<?teng frag row?>${id}"
+                     "<?teng frag tag?>[${name}]<?teng endfrag?>,"
+                     "<?teng endfrag?>";
+            auto result = g(t, doc);
+
+            THEN("They are fragments and fragment lists") {
+                REQUIRE(result == "john:1,2[new],");
+            }
+        }
+
+        WHEN("The array of scalars and null value are rendered") {
+            Teng::Error_t err;
+            auto t = "${$$nums[1]}|${nothing}";
+            auto result = g(err, t, doc);
+
+            THEN("Array items are accessible by index and null is undefined") {
+                REQUIRE(result == "2|undefined");
+            }
+        }
+    }
+
+    GIVEN("JSON document with escaped unicode and duplicate keys") {
+        Teng::JsonDocument_t doc(R"({
+            "pair": "\ud83d\ude00",
+            "lone": "\ud800x\udc00",
+            "key": 1,
+            "key": 2
+        })");
+
+        WHEN("The values are rendered") {
+            auto t = "${pair}|${lone}|${key}";
+            auto result = g(t, doc);
+
+            THEN("Lone surrogates are replaced and first key wins") {
+                REQUIRE(result == "\xf0\x9f\x98\x80|"
+                                  "\xef\xbf\xbdx\xef\xbf\xbd|1");
+            }
+        }
+    }
+
+    GIVEN("Invalid JSON documents") {
+        THEN("The parse error is thrown") {
+            REQUIRE_THROWS_AS(Teng::JsonDocument_t(""), std::runtime_error);
+            REQUIRE_THROWS_AS(Teng::JsonDocument_t("[]"), std::runtime_error);
+            REQUIRE_THROWS_AS(
+                Teng::JsonDocument_t(R"({"a": 1,})"),
+                std::runtime_error
+            );
+            REQUIRE_THROWS_AS(
+                Teng::JsonDocument_t(R"({"a": "\x"})"),
+                std::runtime_error
+            );
+        }
+    }
+}
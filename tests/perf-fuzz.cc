@@ -0,0 +1,255 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- fuzzer looking for inputs with super-linear cost.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+#include <teng/teng.h>
+
+#include "alloccount.h"
+
+namespace {
+
+// each input is measured as is and scaled up by this factor
+constexpr std::size_t SCALE = 4;
+
+// the cost may grow SLACK times faster than the input before it is flagged
+constexpr double SLACK = 2.5;
+
+// the scaled inputs cheaper than this are never flagged (noise)
+constexpr uint64_t MIN_NS = 5 * 1000 * 1000;
+
+// the number of fragments in data tree for unscaled input
+constexpr std::size_t ROWS = 16;
+
+// the number of conditions the input is nested in for unscaled nesting, it
+// is high so the cost of the nesting itself is not lost in the noise
+constexpr std::size_t DEPTH = 256;
+
+/** The cost of compilation and rendering of one input.
+ */
+struct Cost_t {
+    uint64_t compile_ns = 0; //!< the compile time
+    uint64_t render_ns = 0;  //!< the best render time of warm program
+    uint64_t allocs = 0;     //!< the allocations done by one render
+    uint64_t bytes = 0;      //!< the bytes allocated by one render
+    std::size_t output = 0;  //!< the output size
+
+    /** Returns the compile and the render time.
+     */
+    uint64_t total() const {return compile_ns + render_ns;}
+};
+
+/** Returns the data tree with given number of rows the fuzzed templates can
+ * iterate over.
+ */
+Teng::Fragment_t make_data(std::size_t rows) {
+    Teng::Fragment_t root;
+    root.addVariable("a", "123");
+    root.addVariable("b", -1);
+    root.addVariable("s", "aaaaaaaaaaaaaaaaaa!");
+    for (std::size_t i = 0; i < rows; ++i) {
+        auto &row = root.addFragment("row");
+        row.addVariable("i", static_cast<Teng::IntType_t>(i));
+        row.addVariable("s", "<b>row</b> & \"text\"");
+        for (std::size_t j = 0; j < 3; ++j)
+            row.addFragment("item").addVariable("j", static_cast<int>(j));
+    }
+    return root;
+}
+
+/** Compiles and renders the template and returns its cost.
+ */
+Cost_t measure(const std::string &templ, const Teng::Fragment_t &data) {
+    Teng::Teng_t teng;
+    Teng::Teng_t::GenPageArgs_t args;
+    args.templateString = templ;
+
+    Cost_t cost;
+    for (auto i = 0; i < 3; ++i) {
+        Teng::Error_t err;
+        std::string result;
+        Teng::StringWriter_t writer(result);
+
+        auto allocs = Teng::test::alloc_stats();
+        auto start = std::chrono::steady_clock::now();
+        teng.generatePage(args, data, writer, err);
+        auto finish = std::chrono::steady_clock::now();
+        allocs = Teng::test::alloc_stats() - allocs;
+
+        // the first render compiles the template
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            finish - start
+        ).count();
+        if (i == 0) {
+            cost.compile_ns = teng.cacheStats().programs.loadTime;
+            continue;
+        }
+        if (i == 1 || ns < cost.render_ns) cost.render_ns = ns;
+        cost.allocs = allocs.count;
+        cost.bytes = allocs.bytes;
+        cost.output = result.size();
+    }
+    return cost;
+}
+
+/** Returns the template nested in given number of conditions.
+ */
+std::string nest(const std::string &templ, std::size_t levels) {
+    std::string result;
+    for (std::size_t i = 0; i < levels; ++i) result += "<?teng if a?>";
+    result += templ;
+    for (std::size_t i = 0; i < levels; ++i) result += "<?teng endif?>";
+    return result;
+}
+
+/** The costs of the input and its scaled up variants.
+ */
+struct Verdict_t {
+    Cost_t base;         //!< the input as is
+    Cost_t long_templ;   //!< the input repeated SCALE times
+    Cost_t large_data;   //!< the input rendered with SCALE times more rows
+    Cost_t nested;       //!< the input nested in DEPTH conditions
+    Cost_t deep_nested;  //!< the input nested in SCALE times more conditions
+
+    /** Returns how many times the cost has grown.
+     */
+    static double ratio(const Cost_t &scaled, const Cost_t &base) {
+        auto base_total = std::max<uint64_t>(base.total(), 1);
+        return double(scaled.total()) / double(base_total);
+    }
+
+    /** Returns true if the cost grows super-linearly with the input.
+     */
+    static bool superlinear(const Cost_t &scaled, const Cost_t &base) {
+        return scaled.total() > MIN_NS && ratio(scaled, base) > SCALE * SLACK;
+    }
+
+    /** Returns true if any of scaled inputs is super-linear.
+     */
+    bool flagged() const {
+        return superlinear(long_templ, base)
+            || superlinear(large_data, base)
+            || superlinear(deep_nested, nested);
+    }
+};
+
+/** Measures the input and its scaled up variants.
+ */
+Verdict_t check(const std::string &templ) {
+    std::string long_templ;
+    long_templ.reserve(templ.size() * SCALE);
+    for (std::size_t i = 0; i < SCALE; ++i) long_templ += templ;
+
+    auto data = make_data(ROWS);
+    auto large_data = make_data(ROWS * SCALE);
+    return {
+        measure(templ, data),
+        measure(long_templ, data),
+        measure(templ, large_data),
+        measure(nest(templ, DEPTH), data),
+        measure(nest(templ, DEPTH * SCALE), data)
+    };
+}
+
+/** Writes the verdict as one line JSON object.
+ */
+void report(std::ostream &os, const std::string &name, const Verdict_t &v) {
+    os << "{\"input\": \"" << name << "\""
+       << ", \"compile_ns\": " << v.base.compile_ns
+       << ", \"render_ns\": " << v.base.render_ns
+       << ", \"allocs\": " << v.base.allocs
+       << ", \"alloc_bytes\": " << v.base.bytes
+       << ", \"output_bytes\": " << v.base.output
+       << ", \"templ_ratio\": " << Verdict_t::ratio(v.long_templ, v.base)
+       << ", \"data_ratio\": " << Verdict_t::ratio(v.large_data, v.base)
+       << ", \"nesting_ratio\": "
+       << Verdict_t::ratio(v.deep_nested, v.nested)
+       << ", \"superlinear\": " << (v.flagged()? "true": "false")
+       << "}" << std::endl;
+}
+
+} // namespace
+
+extern "C" {
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    std::string templ(reinterpret_cast<const char *>(data), size);
+    auto verdict = check(templ);
+    if (verdict.flagged()) {
+        // let the fuzzer save the input as the crash artifact
+        report(std::cerr, "fuzzed", verdict);
+        std::abort();
+    }
+    return 0;
+}
+
+} // extern "C"
+
+#ifdef PERF_FUZZ_MAIN
+
+int main(int argc, char *argv[]) {
+    if (argc <= 1) {
+        std::cerr << "Usage: ./perf-fuzz corpus-file..." << std::endl;
+        return -1;
+    }
+
+    // measure each input of the corpus
+    int result = EXIT_SUCCESS;
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i]);
+        if (!file) {
+            std::cerr << "can't open file: " << argv[i] << std::endl;
+            return -2;
+        }
+        std::string templ(
+            (std::istreambuf_iterator<char>(file)),
+            std::istreambuf_iterator<char>()
+        );
+        auto verdict = check(templ);
+        report(std::cout, argv[i], verdict);
+        if (verdict.flagged()) result = EXIT_FAILURE;
+    }
+    return result;
+}
+
+#endif /* PERF_FUZZ_MAIN */
@@ -0,0 +1,412 @@
+/*
+ * Teng -- a general purpose templating engine.
+ * Copyright (C) 2004  Seznam.cz, a.s.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Seznam.cz, a.s.
+ * Naskove 1, Praha 5, 15000, Czech Republic
+ * http://www.seznam.cz, mailto:teng@firma.seznam.cz
+ *
+ *
+ *
+ * $Id: $
+ *
+ * DESCRIPTION
+ * Teng engine -- rendering benchmark of realistic pages.
+ *
+ * AUTHORS
+ * agent <agent@local>
+ *
+ * HISTORY
+ * 2026-10-19  (agent)
+ *             Created.
+ */
+
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <teng/teng.h>
+
+#include "alloccount.h"
+
+#ifndef SRC_DIR
+#define SRC_DIR "."
+#endif /* SRC_DIR */
+
+#define TEST_ROOT SRC_DIR "/tests/"
+
+namespace {
+
+/** The page that is rendered repeatedly.
+ */
+struct Workload_t {
+    std::string name;                    //!< the workload name
+    std::string templ;                   //!< the template source
+    Teng::Fragment_t data;               //!< the data tree
+    std::string ct = "text/html";        //!< the content type
+    bool cold = false;                   //!< compile template for each render
+};
+
+/** The measurement of one render.
+ */
+struct Sample_t {
+    double ns;                           //!< the render latency
+    Teng::test::AllocStats_t allocs;     //!< the allocations done by render
+    std::size_t bytes;                   //!< the output size
+};
+
+/** The aggregated measurements of the workload.
+ */
+struct Report_t {
+    std::string name;                    //!< the workload name
+    std::size_t iterations;              //!< the number of renders
+    double renders_per_sec;              //!< the throughput
+    double mb_per_sec;                   //!< the throughput of output
+    double mean_us;                      //!< the mean latency
+    double p50_us;                       //!< the median latency
+    double p99_us;                       //!< the 99th percentile latency
+    double allocs_per_render;            //!< the mean number of allocations
+    double alloc_bytes_per_render;       //!< the mean number of bytes
+    std::size_t output_bytes;            //!< the output size
+};
+
+/** Listing page: sections of items with nested tags.
+ */
+Workload_t listing(std::size_t sections, std::size_t items) {
+    Workload_t workload;
+    workload.name = "listing";
+    workload.templ
+        = "<html><body><h1>${title}</h1>\n"
+          "<?teng frag section?><h2>${name}</h2><ul>\n"
+          "<?teng frag item?>"
+          "<li class='"
+          "<?teng if _index % 2?>odd<?teng else?>even<?teng endif?>'>"
+          "<a href='${url}?id=${id}'>${name}</a> ${price} Kc"
+          "<?teng frag tag?> <span>${name}</span><?teng endfrag?>"
+          "<?teng if _last?> (last of ${_count})<?teng endif?></li>\n"
+          "<?teng endfrag?></ul>\n"
+          "<?teng endfrag?></body></html>\n";
+    auto &root = workload.data;
+    root.addVariable("title", "Products");
+    for (std::size_t i = 0; i < sections; ++i) {
+        auto &section = root.addFragment("section");
+        section.addVariable("name", "Section " + std::to_string(i));
+        for (std::size_t j = 0; j < items; ++j) {
+            auto &item = section.addFragment("item");
+            item.addVariable("id", static_cast<Teng::IntType_t>(j));
+            item.addVariable("name", "product name " + std::to_string(j));
+            item.addVariable("url", "https://example.com/product");
+            item.addVariable("price", static_cast<Teng::IntType_t>(j * 10));
+            for (auto *tag: {"new", "sale", "top"})
+                item.addFragment("tag").addVariable("name", tag);
+        }
+    }
+    return workload;
+}
+
+/** Page which most of content has to be escaped.
+ */
+Workload_t escaping(std::size_t rows) {
+    Workload_t workload;
+    workload.name = "escaping";
+    workload.templ
+        = "<?teng frag row?><p title=\"${title}\">${text}</p>"
+          "<script>var text = '<?teng ctype 'quoted-string'?>${text}"
+          "<?teng endctype?>';</script>\n<?teng endfrag?>";
+    for (std::size_t i = 0; i < rows; ++i) {
+        auto &row = workload.data.addFragment("row");
+        row.addVariable("title", "\"quoted\" & <tagged> title");
+        row.addVariable(
+            "text",
+            "Some <b>bold</b> & \"quoted\" text with 'apostrophes', "
+            "<a href=\"?a=1&b=2\">links</a> and\nnew lines & more <i>tags</i>"
+        );
+    }
+    return workload;
+}
+
+/** Page with lot of conditions, expressions and function calls.
+ */
+Workload_t expressions(std::size_t rows) {
+    Workload_t workload;
+    workload.name = "expressions";
+    workload.templ
+        = "<?teng frag row?>"
+          "<?teng if price > 1000 && available == 1?>expensive"
+          "<?teng elseif name =~ /name [0-9]*5$/?>fives"
+          "<?teng elseif price % 3 == 0 || !available?>cheap"
+          "<?teng else?>other<?teng endif?>: "
+          "${numformat(price * 1.21, 2, ',', ' ')} "
+          "${available? 'in stock': 'sold out'} "
+          "${case(price % 4, 0: 'a', 1: 'b', *: 'c')} "
+          "${substr(strtoupper(name), 0, 7)}/${len(name)}"
+          "<?teng set total = price + _index * 2?> ${total}\n"
+          "<?teng endfrag?>";
+    for (std::size_t i = 0; i < rows; ++i) {
+        auto &row = workload.data.addFragment("row");
+        row.addVariable("name", "product name " + std::to_string(i));
+        row.addVariable("price", static_cast<Teng::IntType_t>(i * 7 % 2000));
+        row.addVariable("available", static_cast<Teng::IntType_t>(i % 2));
+    }
+    return workload;
+}
+
+/** Page at the end of extends chain page -> section -> layout. Each level
+ * overrides most of the eight blocks of the layout and calls super, so the
+ * overrides of every block are parsed and chained at each level.
+ */
+Workload_t inheritance(std::size_t rows) {
+    Workload_t workload;
+    workload.name = "inheritance";
+    workload.templ
+        = "<?teng extends file='perf-page.html'?>"
+          "<?teng override block head?><title>${title}</title>"
+          "<?teng super block?><?teng endoverride block?>"
+          "<?teng override block header?><h1>${title}</h1>"
+          "<?teng super block?><?teng endoverride block?>"
+          "<?teng override block main?><?teng frag row?>"
+          "<div>${name}: <?teng super block?></div>\n"
+          "<?teng endfrag?><?teng endoverride block?>"
+          "<?teng override block aside?>${count($$row)} rows"
+          "<?teng super block?><?teng endoverride block?>"
+          "<?teng override block footer?><?teng super block?>"
+          "<p>${title}</p><?teng endoverride block?>"
+          "<?teng endextends?>";
+    workload.data.addVariable("title", "Inheritance");
+    for (std::size_t i = 0; i < rows; ++i)
+        workload.data.addFragment("row").addVariable("name", std::to_string(i));
+    return workload;
+}
+
+/** Page with lot of dictionary lookups.
+ */
+Workload_t dictionary(std::size_t rows) {
+    Workload_t workload;
+    workload.name = "dictionary";
+    workload.templ
+        = "<?teng frag row?>#{hello_world}, #{hello_europe}: "
+          "${#html_value} #{text_version} "
+          "${getdict('dict_' + suffix, 'none')} "
+          "${dictexist(key)? getdict(key, ''): 'missing'}\n"
+          "<?teng endfrag?>";
+    for (std::size_t i = 0; i < rows; ++i) {
+        auto &row = workload.data.addFragment("row");
+        row.addVariable("suffix", "txt");
+        row.addVariable("key", i % 2? "version": "unknown");
+    }
+    return workload;
+}
+
+/** Listing page compiled for each render.
+ */
+Workload_t compilation() {
+    auto workload = listing(1, 10);
+    workload.name = "compilation";
+    workload.cold = true;
+    return workload;
+}
+
+/** Extends chain compiled for each render, it measures the parsing of the
+ * overrides.
+ */
+Workload_t inheritance_compilation() {
+    auto workload = inheritance(10);
+    workload.name = "inheritance-compilation";
+    workload.cold = true;
+    return workload;
+}
+
+/** Returns all workloads.
+ */
+std::vector<Workload_t> make_workloads() {
+    std::vector<Workload_t> workloads;
+    workloads.push_back(listing(20, 100));
+    workloads.push_back(escaping(1000));
+    workloads.push_back(expressions(2000));
+    workloads.push_back(inheritance(1000));
+    workloads.push_back(dictionary(1000));
+    workloads.push_back(compilation());
+    workloads.push_back(inheritance_compilation());
+    return workloads;
+}
+
+/** Renders the page once and measures it.
+ */
+Sample_t render(const Teng::Teng_t &warm, const Workload_t &workload) {
+    Teng::Teng_t::GenPageArgs_t args;
+    args.templateString = workload.templ;
+    args.contentType = workload.ct;
+    args.paramsFilename = TEST_ROOT "teng.conf";
+    args.dictFilename = TEST_ROOT "dict.txt";
+    Teng::Error_t err;
+    std::string result;
+
+    auto start_allocs = Teng::test::alloc_stats();
+    auto start = std::chrono::steady_clock::now();
+    {
+        Teng::StringWriter_t writer(result);
+        if (workload.cold) {
+            Teng::Teng_t teng(TEST_ROOT);
+            teng.generatePage(args, workload.data, writer, err);
+        } else warm.generatePage(args, workload.data, writer, err);
+    }
+    auto finish = std::chrono::steady_clock::now();
+    auto allocs = Teng::test::alloc_stats() - start_allocs;
+
+    // the broken workload would measure something else than expected
+    for (auto &entry: err.getEntries())
+        if (entry.level >= Teng::Error_t::ERROR)
+            throw std::runtime_error(workload.name + ": " + entry.getLogLine());
+
+    std::chrono::duration<double, std::nano> ns = finish - start;
+    return {ns.count(), allocs, result.size()};
+}
+
+/** Returns the percentile of sorted latencies in microseconds.
+ */
+double percentile(const std::vector<double> &sorted, double p) {
+    auto rank = static_cast<std::size_t>(std::ceil(p * double(sorted.size())));
+    return sorted[std::max<std::size_t>(rank, 1) - 1] / 1000.0;
+}
+
+/** Renders the workload repeatedly and aggregates the measurements.
+ */
+Report_t run(const Workload_t &workload, std::size_t iterations) {
+    Teng::Teng_t teng(TEST_ROOT);
+    for (auto i = 0; i < 3; ++i) render(teng, workload);
+
+    std::vector<Sample_t> samples;
+    samples.reserve(iterations);
+    for (std::size_t i = 0; i < iterations; ++i)
+        samples.push_back(render(teng, workload));
+
+    double total_ns = 0, allocs = 0, alloc_bytes = 0;
+    std::vector<double> latencies;
+    latencies.reserve(samples.size());
+    for (auto &sample: samples) {
+        total_ns += sample.ns;
+        allocs += double(sample.allocs.count);
+        alloc_bytes += double(sample.allocs.bytes);
+        latencies.push_back(sample.ns);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    auto n = double(samples.size());
+    auto output_bytes = samples.back().bytes;
+    return {
+        workload.name,
+        samples.size(),
+        n / (total_ns / 1e9),
+        n * double(output_bytes) / (total_ns / 1e3),
+        total_ns / n / 1000.0,
+        percentile(latencies, 0.50),
+        percentile(latencies, 0.99),
+        allocs / n,
+        alloc_bytes / n,
+        output_bytes
+    };
+}
+
+/** Writes report as one line JSON object.
+ */
+void write_json(std::ostream &os, const Report_t &report) {
+    os << std::fixed << std::setprecision(3)
+       << "{\"workload\": \"" << report.name << "\""
+       << ", \"iterations\": " << report.iterations
+       << ", \"renders_per_sec\": " << report.renders_per_sec
+       << ", \"mb_per_sec\": " << report.mb_per_sec
+       << ", \"mean_us\": " << report.mean_us
+       << ", \"p50_us\": " << report.p50_us
+       << ", \"p99_us\": " << report.p99_us
+       << ", \"allocs_per_render\": " << report.allocs_per_render
+       << ", \"alloc_bytes_per_render\": " << report.alloc_bytes_per_render
+       << ", \"output_bytes\": " << report.output_bytes
+       << "}" << std::endl;
+}
+
+/** Writes report as CSV line.
+ */
+void write_csv(std::ostream &os, const Report_t &report) {
+    os << std::fixed << std::setprecision(3)
+       << report.name << ',' << report.iterations
+       << ',' << report.renders_per_sec << ',' << report.mb_per_sec
+       << ',' << report.mean_us << ',' << report.p50_us
+       << ',' << report.p99_us << ',' << report.allocs_per_render
+       << ',' << report.alloc_bytes_per_render
+       << ',' << report.output_bytes << std::endl;
+}
+
+/** Prints usage.
+ */
+int usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--iterations=N] [--csv] "
+              << "[workload...]" << std::endl
+              << "Workloads: listing escaping expressions inheritance "
+              << "dictionary compilation inheritance-compilation"
+              << std::endl;
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::size_t iterations = 100;
+    bool csv = false;
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 13, "--iterations=") == 0) {
+            iterations = std::strtoul(arg.c_str() + 13, nullptr, 10);
+            if (!iterations) return usage(argv[0]);
+        } else if (arg == "--csv") {
+            csv = true;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            return usage(argv[0]);
+        } else selected.push_back(arg);
+    }
+
+    if (csv)
+        std::cout << "workload,iterations,renders_per_sec,mb_per_sec,mean_us,"
+                  << "p50_us,p99_us,allocs_per_render,alloc_bytes_per_render,"
+                  << "output_bytes" << std::endl;
+
+    try {
+        for (auto &workload: make_workloads()) {
+            if (!selected.empty()) {
+                auto iselected = std::find(
+                    selected.begin(),
+                    selected.end(),
+                    workload.name
+                );
+                if (iselected == selected.end()) continue;
+            }
+            auto report = run(workload, iterations);
+            csv? write_csv(std::cout, report): write_json(std::cout, report);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -241,3 +241,329 @@ SCENARIO(
     }
 }
 
+
+SCENARIO(
+    "Reserving writer space for the page",
+    "[basic]"
+) {
+    struct ReservingWriter_t: public Teng::StringWriter_t {
+        ReservingWriter_t(std::string &str): StringWriter_t(str) {}
+        void reserve(std::size_t size) override {reserved.push_back(size);}
+        std::vector<std::size_t> reserved;
+    };
+
+    GIVEN("Engine and template generating page of known size") {
+        Teng::Teng_t teng(TEST_ROOT);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.templateString = "<?teng frag a?>${b}<?teng endfrag?>";
+        Teng::Fragment_t root;
+        for (auto i = 0; i < 8; ++i)
+            root.addFragment("a").addVariable("b", "x");
+
+        WHEN("Pages are generated without reserving") {
+            Teng::Error_t err;
+            std::string result;
+            ReservingWriter_t writer(result);
+            teng.generatePage(args, root, writer, err);
+            teng.generatePage(args, root, writer, err);
+
+            THEN("The writer is never asked for reservation") {
+                REQUIRE(result == "xxxxxxxxxxxxxxxx");
+                REQUIRE(writer.reserved.empty());
+            }
+        }
+
+        WHEN("Pages are generated with reserving") {
+            Teng::Error_t err;
+            std::string result;
+            ReservingWriter_t writer(result);
+            args.reserveOutput = true;
+            teng.generatePage(args, root, writer, err);
+            teng.generatePage(args, root, writer, err);
+
+            THEN("The second page reserves the size of the first one") {
+                REQUIRE(result == "xxxxxxxxxxxxxxxx");
+                REQUIRE(writer.reserved == std::vector<std::size_t>{9});
+            }
+        }
+    }
+
+    GIVEN("Engine and template generating page of 256 bytes") {
+        struct CapacityWriter_t: public Teng::StringWriter_t {
+            CapacityWriter_t(std::string &str)
+                : StringWriter_t(str), str(str), capacity(str.capacity())
+            {}
+            void reserve(std::size_t size) override {
+                StringWriter_t::reserve(size);
+                capacity = str.capacity();
+            }
+            std::string &str;
+            std::size_t capacity;
+        };
+
+        Teng::Teng_t teng(TEST_ROOT);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.templateString = "<?teng frag a?>${b}<?teng endfrag?>";
+        args.reserveOutput = true;
+        Teng::Fragment_t root;
+        for (auto i = 0; i < 256; ++i)
+            root.addFragment("a").addVariable("b", "x");
+
+        WHEN("The second page is generated to the empty string") {
+            Teng::Error_t err;
+            std::string first;
+            Teng::StringWriter_t first_writer(first);
+            teng.generatePage(args, root, first_writer, err);
+            std::string result;
+            CapacityWriter_t writer(result);
+            auto initial_capacity = result.capacity();
+            teng.generatePage(args, root, writer, err);
+
+            THEN("The string capacity grows before anything is written") {
+                REQUIRE(result.size() == 256);
+                REQUIRE(initial_capacity < 256);
+                REQUIRE(writer.capacity >= 256 + 256 / 8);
+                REQUIRE(result.capacity() == writer.capacity);
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Collecting render statistics of templates",
+    "[basic]"
+) {
+    GIVEN("Engine collecting stats and two templates") {
+        Teng::Teng_t::Settings_t settings;
+        settings.collectStats = true;
+        Teng::Teng_t teng(TEST_ROOT, settings);
+        Teng::Teng_t::GenPageArgs_t args;
+        Teng::Fragment_t root;
+        for (auto i = 0; i < 4; ++i)
+            root.addFragment("a").addVariable("b", "x");
+
+        WHEN("The templates are rendered several times") {
+            args.templateString = "<?teng frag a?>${b}<?teng endfrag?>";
+            for (auto i = 0; i < 3; ++i)
+                g(teng, args, root);
+            args.templateString = "static";
+            g(teng, args, root);
+            auto stats = teng.templateStats();
+
+            THEN("Each template has its own stats") {
+                REQUIRE(stats.size() == 2);
+                auto &frag = stats[0].renders == 3? stats[0]: stats[1];
+                auto &stat = stats[0].renders == 3? stats[1]: stats[0];
+                REQUIRE(frag.renders == 3);
+                REQUIRE(frag.compiles == 1);
+                REQUIRE(frag.bytes == 12);
+                REQUIRE(frag.instructions > 3 * 4);
+                REQUIRE(frag.renderTime >= frag.renderTimeP99);
+                REQUIRE(frag.renderTimeP99 >= frag.renderTimeP50);
+                REQUIRE(frag.contentType == "text/html");
+                REQUIRE(stat.renders == 1);
+                REQUIRE(stat.compiles == 1);
+                REQUIRE(stat.bytes == 6);
+            }
+
+            THEN("The stats can be reset") {
+                teng.resetTemplateStats();
+                REQUIRE(teng.templateStats().empty());
+                g(teng, args, root);
+                REQUIRE(teng.templateStats().size() == 1);
+                REQUIRE(teng.templateStats()[0].compiles == 0);
+            }
+        }
+    }
+
+    GIVEN("Engine collecting stats with program cache for one template") {
+        Teng::Teng_t::Settings_t settings(1);
+        settings.collectStats = true;
+        Teng::Teng_t teng(TEST_ROOT, settings);
+        Teng::Teng_t::GenPageArgs_t first, second;
+        first.templateString = "first";
+        second.templateString = "second";
+
+        WHEN("The program of the first template is evicted") {
+            g(teng, first);
+            g(teng, second);
+            auto stats = teng.templateStats();
+
+            THEN("Its stats are dropped") {
+                REQUIRE(stats.size() == 1);
+                REQUIRE(stats[0].bytes == 6);
+            }
+        }
+    }
+
+    GIVEN("Engine that does not collect stats") {
+        Teng::Teng_t teng(TEST_ROOT);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.templateString = "text";
+        g(teng, args);
+
+        THEN("There are no stats") {
+            REQUIRE(teng.templateStats().empty());
+        }
+    }
+}
+
+SCENARIO(
+    "Counting cache hits, misses and evictions",
+    "[basic]"
+) {
+    GIVEN("Engine with program cache for one template") {
+        std::vector<Teng::CacheEvent_t> events;
+        Teng::Teng_t::Settings_t settings(1);
+        settings.cacheCallback = [&] (const Teng::CacheEvent_t &event) {
+            if (event.cache == Teng::CacheEvent_t::PROGRAMS)
+                events.push_back(event);
+        };
+        Teng::Teng_t teng(TEST_ROOT, settings);
+        Teng::Teng_t::GenPageArgs_t first, second;
+        first.templateString = "first";
+        second.templateString = "second";
+
+        WHEN("Two templates are rendered alternately") {
+            g(teng, first);
+            g(teng, first);
+            g(teng, second);
+            g(teng, first);
+            auto stats = teng.cacheStats();
+
+            THEN("The program cache thrashes") {
+                REQUIRE(stats.programs.hits == 1);
+                REQUIRE(stats.programs.misses == 3);
+                REQUIRE(stats.programs.evictions == 2);
+                REQUIRE(stats.programs.loads == 3);
+                REQUIRE(stats.programs.changedReloads == 0);
+                REQUIRE(stats.programs.dependReloads == 0);
+                REQUIRE(stats.params.misses == 1);
+                REQUIRE(stats.params.hits == 3);
+                REQUIRE(stats.dicts.misses == 1);
+                REQUIRE(stats.dicts.hits == 3);
+            }
+
+            THEN("The callback is called on each load and eviction") {
+                using Event_t = Teng::CacheEvent_t;
+                REQUIRE(events.size() == 5);
+                REQUIRE(events[0].reason == Event_t::MISSING);
+                REQUIRE(events[1].reason == Event_t::MISSING);
+                REQUIRE(events[2].reason == Event_t::EVICTED);
+                REQUIRE(events[2].key == events[0].key);
+                REQUIRE(events[3].reason == Event_t::MISSING);
+                REQUIRE(events[4].reason == Event_t::EVICTED);
+                REQUIRE(events[4].key == events[1].key);
+            }
+
+            THEN("The counters can be reset") {
+                teng.resetCacheStats();
+                g(teng, first);
+                auto fresh = teng.cacheStats();
+                REQUIRE(fresh.programs.hits == 1);
+                REQUIRE(fresh.programs.misses == 0);
+                REQUIRE(fresh.programs.evictions == 0);
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Estimating memory footprint of cached programs and dictionaries",
+    "[basic]"
+) {
+    GIVEN("Engine and templates of different size") {
+        Teng::Teng_t teng(TEST_ROOT);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.dictFilename = "dict.txt";
+
+        WHEN("The small template is cached") {
+            args.templateString = "${a}";
+            g(teng, args);
+            auto small = teng.cacheStats();
+
+            THEN("Its footprint is nonzero and stable") {
+                REQUIRE(small.programs.memory > 0);
+                REQUIRE(small.dicts.memory > 0);
+                REQUIRE(small.params.memory > 0);
+                REQUIRE(teng.cacheStats().programs.memory
+                        == small.programs.memory);
+            }
+
+            WHEN("The large template is cached too") {
+                std::string big(16 * 1024, 'x');
+                args.templateString = "${a =~ /" + big + "/}" + big + "${b}";
+                g(teng, args);
+                auto large = teng.cacheStats();
+
+                THEN("The footprint grows by at least its strings") {
+                    REQUIRE(large.programs.memory
+                            > small.programs.memory + 2 * big.size());
+                    REQUIRE(large.dicts.memory == small.dicts.memory);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO(
+    "Tracing render phases",
+    "[basic]"
+) {
+    struct Recorder_t: public Teng::Tracer_t {
+        void begin(Phase_t phase, const std::string &detail) override {
+            events.push_back(std::string("+") + name(phase) + ":" + detail);
+        }
+        void end(Phase_t phase) override {
+            events.push_back(std::string("-") + name(phase));
+        }
+        std::vector<std::string> events;
+    };
+
+    GIVEN("Engine with tracer and template with include") {
+        auto recorder = std::make_shared<Recorder_t>();
+        Teng::Teng_t::Settings_t settings;
+        settings.tracer = recorder;
+        Teng::Teng_t teng(TEST_ROOT, settings);
+        Teng::Teng_t::GenPageArgs_t args;
+        args.templateString = "<?teng include file='text.txt'?>";
+
+        WHEN("The template is rendered for the first time") {
+            g(teng, args);
+
+            THEN("All phases are traced and properly nested") {
+                std::vector<std::string> events{
+                    "+cache-lookup:",
+                    "+compile:",
+                    "+load:text.txt",
+                    "-load",
+                    "-compile",
+                    "-cache-lookup",
+                    "+execute:",
+                    "-execute",
+                    "+flush:",
+                    "-flush",
+                };
+                REQUIRE(recorder->events == events);
+            }
+        }
+
+        WHEN("The template is rendered again") {
+            g(teng, args);
+            recorder->events.clear();
+            g(teng, args);
+
+            THEN("The cached program is not compiled") {
+                std::vector<std::string> events{
+                    "+cache-lookup:",
+                    "-cache-lookup",
+                    "+execute:",
+                    "-execute",
+                    "+flush:",
+                    "-flush",
+                };
+                REQUIRE(recorder->events == events);
+            }
+        }
+    }
+}
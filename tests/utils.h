@@ -46,9 +46,10 @@
 
 using Catch::Approx;
 
-inline std::string g(
+template <typename Data_t = Teng::Fragment_t>
+std::string g(
     const std::string &templ,
-    const Teng::Fragment_t &data = {},
+    const Data_t &data = {},
     const std::string &ct = "text/html",
     const std::string &encoding = "utf-8"
 ) {
@@ -64,10 +65,11 @@ inline std::string g(
     return result;
 }
 
-inline std::string g(
+template <typename Data_t = Teng::Fragment_t>
+std::string g(
     Teng::Error_t &err,
     const std::string &templ,
-    const Teng::Fragment_t &data = {},
+    const Data_t &data = {},
     const std::string &params = "teng.conf",
     const std::string &lang = "",
     const std::string &ct = "text/html",
@@ -87,6 +89,19 @@ inline std::string g(
     return result;
 }
 
+template <typename Data_t = Teng::Fragment_t>
+std::string g(
+    Teng::Teng_t &teng,
+    const Teng::Teng_t::GenPageArgs_t &args,
+    const Data_t &data = {}
+) {
+    std::string result;
+    Teng::StringWriter_t writer(result);
+    Teng::Error_t err;
+    teng.generatePage(args, data, writer, err);
+    return result;
+}
+
 inline std::string gFromFile(
     Teng::Error_t &err,
     const std::string &filename,
@@ -1354,3 +1354,28 @@ SCENARIO(
 }
 
 
+
+SCENARIO(
+    "Many local variables in loops",
+    "[vars][regvars]"
+) {
+    GIVEN("Some data with nested fragments") {
+        Teng::Fragment_t root;
+        for (auto i = 0; i < 3; ++i)
+            root.addFragment("row").addFragment("cell").addVariable("i", i);
+
+        WHEN("More variables than fit inline are set in each iteration") {
+            auto t = "<?frag row?><?frag cell?>"
+                     "<?set a = i?><?set b = a + 1?><?set c = b + 1?>"
+                     "<?set d = c + 1?><?set e = d + 1?><?set f = e + 1?>"
+                     "<?set a = f + 1?>${a}${b}${c}${d}${e}${f}"
+                     "<?frag .row?><?endfrag?>;"
+                     "<?endfrag?><?endfrag?>";
+            auto result = g(t, root);
+
+            THEN("All variables are set and cleared for next iteration") {
+                REQUIRE(result == "612345;723456;834567;");
+            }
+        }
+    }
+}